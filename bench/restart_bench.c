@@ -0,0 +1,126 @@
+/*******************************************************************************
+*
+* FILENAME : restart_bench.c
+*
+* DESCRIPTION : Measures how long starting a process takes with each of the
+* ways the watchdog can restart a process, depending on the resident set size
+* of the caller.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE /* vfork */
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc, free */
+#include <string.h> /* memset */
+#include <time.h> /* clock_gettime */
+#include <unistd.h> /* fork, vfork, execvp */
+#include <spawn.h> /* posix_spawnp */
+#include <sys/wait.h> /* waitpid */
+
+#include "watchdog.h"
+
+#define REPEATS (20)
+#define MB (1024UL * 1024UL)
+#define NSEC_IN_SEC (1000000000.0)
+#define USEC_IN_SEC (1000000.0)
+
+extern char **environ;
+
+static double SpawnOnce(wd_spawn_t spawn, double *exit_time);
+static double Now(void);
+
+int main()
+{
+    size_t rss_mb[] = {0, 256, 1024, 2048};
+    const char *names[] = {"fork", "posix_spawn", "vfork"};
+    size_t i = 0;
+    int spawn = 0;
+
+    printf("%-8s %-12s %16s %16s\n", "rss MB", "spawn", "returned us",
+                                                            "exited us");
+
+    for (i = 0; i < sizeof(rss_mb) / sizeof(rss_mb[0]); ++i)
+    {
+        char *ballast = NULL;
+
+        if (0 != rss_mb[i])
+        {
+            ballast = (char *)malloc(rss_mb[i] * MB);
+            if (NULL == ballast)
+            {
+                printf("%-8lu can't allocate\n", (unsigned long)rss_mb[i]);
+                break;
+            }
+
+            memset(ballast, 1, rss_mb[i] * MB);
+        }
+
+        for (spawn = WD_SPAWN_FORK; spawn <= WD_SPAWN_VFORK; ++spawn)
+        {
+            double returned = 0, exited = 0;
+            int repeat = 0;
+
+            for (repeat = 0; repeat < REPEATS; ++repeat)
+            {
+                double exit_time = 0;
+
+                returned += SpawnOnce((wd_spawn_t)spawn, &exit_time);
+                exited += exit_time;
+            }
+
+            printf("%-8lu %-12s %16.0f %16.0f\n", (unsigned long)rss_mb[i],
+                   names[spawn], returned * USEC_IN_SEC / REPEATS,
+                   exited * USEC_IN_SEC / REPEATS);
+        }
+
+        free(ballast);
+        ballast = NULL;
+    }
+
+    return (0);
+}
+
+/* returns the time the caller was blocked, exit_time gets the full time */
+static double SpawnOnce(wd_spawn_t spawn, double *exit_time)
+{
+    char *argv[] = {"true", NULL};
+    pid_t pid = 0;
+    double start = Now();
+    double returned = 0;
+
+    if (WD_SPAWN_POSIX_SPAWN == spawn)
+    {
+        posix_spawnp(&pid, argv[0], NULL, NULL, argv, environ);
+    }
+    else
+    {
+        pid = (WD_SPAWN_VFORK == spawn) ? vfork() : fork();
+        if (0 == pid)
+        {
+            execvp(argv[0], argv);
+            _exit(1);
+        }
+    }
+
+    returned = Now() - start;
+
+    waitpid(pid, NULL, 0);
+    *exit_time = Now() - start;
+
+    return (returned);
+}
+
+static double Now(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec + now.tv_nsec / NSEC_IN_SEC);
+}
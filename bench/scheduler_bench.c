@@ -0,0 +1,371 @@
+/*******************************************************************************
+*
+* FILENAME : scheduler_bench.c
+*
+* DESCRIPTION : Compares the queues the scheduler can be backed with: adds n
+* tasks, removes some of them by UID and pops the rest. The tasks are created
+* before the timing, so only the queue operations are measured; they are kept
+* the way the scheduler keeps them, including its UID index. Fails if removal
+* by UID from the indexed queues doesn't stay flat as the queues grow.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc, free */
+#include <time.h> /* clock_gettime */
+
+#include "task.h"
+#include "pqueue.h"
+#include "timing_wheel.h"
+#include "hash_table.h"
+
+#define SPREAD_MS (200)
+#define REMOVE_AMOUNT (1000)
+/* adding to the sorted list is O(n), a million tasks would take hours */
+#define SORTED_LIST_MAX_TASKS (100000)
+/* 1k tasks fit in the cache, at 1M each removal misses a few cache lines,
+   which alone costs about x10; a linear removal is x1000 slower */
+#define REMOVE_SCALING_LIMIT (20.0)
+#define NSEC_IN_SEC (1000000000.0)
+
+enum {SORTED_LIST, HEAP, TIMING_WHEEL, BACKENDS_AMOUNT};
+
+typedef struct queue
+{
+    int backend;
+    pq_t *pq;
+    timing_wheel_t *wheel;
+    hash_table_t *index;
+} queue_t;
+
+static const char *g_names[BACKENDS_AMOUNT] = {
+    "sorted_list", "heap", "timing_wheel"
+};
+
+static task_t **g_tasks = NULL;
+static nsrd_uid_t g_uids[REMOVE_AMOUNT];
+
+static double RunBench(size_t tasks_amount, int backend);
+static int QueueCreate(queue_t *queue, int backend);
+static void QueueDestroy(queue_t *queue);
+static int QueueAdd(queue_t *queue, task_t *task, unsigned long tick);
+static void QueueRemove(queue_t *queue, nsrd_uid_t uid);
+static task_t *QueuePop(queue_t *queue);
+static size_t HashUID(const void *uid);
+static double Now(void);
+static op_status_t Nothing(void *params);
+static void NoCleanup(void *params);
+
+int main()
+{
+    size_t amounts[] = {1000, 100000, 1000000};
+    size_t max_amount = amounts[sizeof(amounts) / sizeof(amounts[0]) - 1];
+    double remove_ns[BACKENDS_AMOUNT] = {0};
+    double first_remove_ns[BACKENDS_AMOUNT] = {0};
+    size_t i = 0;
+    int backend = 0;
+    int status = 0;
+
+    g_tasks = (task_t **) malloc(max_amount * sizeof(task_t *));
+    if (NULL == g_tasks)
+    {
+        printf("allocation failed\n");
+        return (1);
+    }
+
+    /* UIDCreate looks up the interfaces, it would dwarf the queue */
+    for (i = 0; i < max_amount; ++i)
+    {
+        g_tasks[i] = TaskCreateMs(Nothing, NoCleanup, NULL, NULL,
+                                                            i % SPREAD_MS);
+        if (NULL == g_tasks[i])
+        {
+            printf("task creation failed\n");
+            max_amount = i;
+            break;
+        }
+    }
+
+    printf("%-8s %-12s %12s %12s %12s\n", "tasks", "backend",
+           "add ns/task", "remove ns", "pop ns/task");
+
+    for (i = 0; i < sizeof(amounts) / sizeof(amounts[0]); ++i)
+    {
+        for (backend = 0; backend < BACKENDS_AMOUNT; ++backend)
+        {
+            if (amounts[i] <= max_amount)
+            {
+                remove_ns[backend] = RunBench(amounts[i], backend);
+            }
+
+            if (0 == i)
+            {
+                first_remove_ns[backend] = remove_ns[backend];
+            }
+        }
+    }
+
+    for (backend = HEAP; backend < BACKENDS_AMOUNT; ++backend)
+    {
+        double scaling = remove_ns[backend] / first_remove_ns[backend];
+
+        printf("%s remove scaling %lu -> %lu tasks: x%.1f\n", g_names[backend],
+               (unsigned long)amounts[0], (unsigned long)max_amount, scaling);
+
+        if (REMOVE_SCALING_LIMIT < scaling)
+        {
+            printf("FAILED: %s removal grows with the queue\n",
+                                                        g_names[backend]);
+            status = 1;
+        }
+    }
+
+    for (i = 0; i < max_amount; ++i)
+    {
+        TaskDestroy(g_tasks[i]);
+    }
+
+    free(g_tasks);
+    g_tasks = NULL;
+
+    return (status);
+}
+
+static double RunBench(size_t tasks_amount, int backend)
+{
+    queue_t queue = {0};
+    size_t removed = 0;
+    size_t popped = 0;
+    size_t i = 0;
+    double start = 0, add_time = 0, remove_time = 0, pop_time = 0;
+
+    if (SORTED_LIST == backend && SORTED_LIST_MAX_TASKS < tasks_amount)
+    {
+        printf("%-8lu %-12s %12s\n", (unsigned long)tasks_amount,
+                                    g_names[backend], "skipped");
+        return (0);
+    }
+
+    if (0 != QueueCreate(&queue, backend))
+    {
+        printf("%-8lu %-12s creation failed\n", (unsigned long)tasks_amount,
+                                                        g_names[backend]);
+        return (0);
+    }
+
+    start = Now();
+    for (i = 0; i < tasks_amount; ++i)
+    {
+        if (0 != QueueAdd(&queue, g_tasks[i], 1 + i % SPREAD_MS))
+        {
+            printf("%-8lu %-12s addition failed\n",
+                   (unsigned long)tasks_amount, g_names[backend]);
+            QueueDestroy(&queue);
+            return (0);
+        }
+    }
+    add_time = Now() - start;
+
+    for (i = 0; i < tasks_amount; i += tasks_amount / REMOVE_AMOUNT + 1)
+    {
+        g_uids[removed] = TaskGetUID(g_tasks[i]);
+        ++removed;
+    }
+
+    start = Now();
+    for (i = 0; i < removed; ++i)
+    {
+        QueueRemove(&queue, g_uids[i]);
+    }
+    remove_time = Now() - start;
+
+    start = Now();
+    while (NULL != QueuePop(&queue))
+    {
+        ++popped;
+    }
+    pop_time = Now() - start;
+
+    printf("%-8lu %-12s %12.0f %12.0f %12.0f\n", (unsigned long)tasks_amount,
+           g_names[backend], add_time * NSEC_IN_SEC / tasks_amount,
+           remove_time * NSEC_IN_SEC / removed,
+           pop_time * NSEC_IN_SEC / popped);
+
+    QueueDestroy(&queue);
+
+    return (remove_time * NSEC_IN_SEC / removed);
+}
+
+static int QueueCreate(queue_t *queue, int backend)
+{
+    queue->backend = backend;
+
+    switch (backend)
+    {
+        case SORTED_LIST:
+            /* the scheduler before the UID index: removal scans the list */
+            queue->pq = PQCreateEx(TaskCompare, PQ_SORTED_LIST);
+            break;
+
+        case HEAP:
+            queue->pq = PQCreateEx(TaskCompare, PQ_HEAP);
+            if (NULL != queue->pq)
+            {
+                PQSetPositionFunc(queue->pq, TaskSetPosition);
+            }
+            queue->index = HashTableCreate(HashUID, TaskIsSame, 0);
+            break;
+
+        default:
+            queue->wheel = TimingWheelCreate();
+            queue->index = HashTableCreate(HashUID, TaskIsSame, 0);
+            break;
+    }
+
+    if ((NULL == queue->pq && NULL == queue->wheel)
+     || (SORTED_LIST != backend && NULL == queue->index))
+    {
+        QueueDestroy(queue);
+
+        return (1);
+    }
+
+    return (0);
+}
+
+static void QueueDestroy(queue_t *queue)
+{
+    if (NULL != queue->pq)
+    {
+        PQDestroy(queue->pq);
+        queue->pq = NULL;
+    }
+
+    if (NULL != queue->wheel)
+    {
+        TimingWheelDestroy(queue->wheel);
+        queue->wheel = NULL;
+    }
+
+    if (NULL != queue->index)
+    {
+        HashTableDestroy(queue->index);
+        queue->index = NULL;
+    }
+}
+
+static int QueueAdd(queue_t *queue, task_t *task, unsigned long tick)
+{
+    tw_timer_t timer = NULL;
+    nsrd_uid_t uid = TaskGetUID(task);
+
+    if (NULL != queue->index && 0 != HashTableInsert(queue->index, &uid, task))
+    {
+        return (1);
+    }
+
+    if (NULL != queue->pq)
+    {
+        return (PQEnqueue(queue->pq, task));
+    }
+
+    timer = TimingWheelAdd(queue->wheel, task, tick);
+    TaskSetHandle(task, timer);
+
+    return (NULL == timer);
+}
+
+static void QueueRemove(queue_t *queue, nsrd_uid_t uid)
+{
+    task_t *task = NULL;
+
+    if (SORTED_LIST == queue->backend)
+    {
+        PQErase(queue->pq, TaskIsSame, &uid);
+        return;
+    }
+
+    task = (task_t *)HashTableRemove(queue->index, &uid);
+
+    if (HEAP == queue->backend)
+    {
+        PQEraseAt(queue->pq, TaskGetPosition(task));
+    }
+    else
+    {
+        TimingWheelRemove(queue->wheel, (tw_timer_t)TaskGetHandle(task));
+    }
+}
+
+static task_t *QueuePop(queue_t *queue)
+{
+    task_t *task = NULL;
+    nsrd_uid_t uid = {0};
+
+    if (NULL != queue->pq)
+    {
+        if (PQIsEmpty(queue->pq))
+        {
+            return (NULL);
+        }
+
+        task = (task_t *)PQDequeue(queue->pq);
+    }
+    else
+    {
+        while (NULL == (task = TimingWheelPopExpired(queue->wheel)))
+        {
+            if (TimingWheelIsEmpty(queue->wheel))
+            {
+                return (NULL);
+            }
+
+            TimingWheelAdvance(queue->wheel,
+                               TimingWheelNextTick(queue->wheel));
+        }
+    }
+
+    if (NULL != queue->index)
+    {
+        uid = TaskGetUID(task);
+        HashTableRemove(queue->index, &uid);
+    }
+
+    return (task);
+}
+
+/* the same hash the scheduler indexes its tasks with */
+static size_t HashUID(const void *uid)
+{
+    const nsrd_uid_t *conv_uid = (const nsrd_uid_t *)uid;
+
+    return (conv_uid->counter ^ ((size_t)conv_uid->pid << 20)
+                              ^ (size_t)conv_uid->timestamp);
+}
+
+static double Now(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec + now.tv_nsec / NSEC_IN_SEC);
+}
+
+static op_status_t Nothing(void *params)
+{
+    (void)params;
+
+    return (COMPLETE);
+}
+
+static void NoCleanup(void *params)
+{
+    (void)params;
+}
@@ -0,0 +1,112 @@
+/*******************************************************************************
+*
+* FILENAME : startup_bench.c
+*
+* DESCRIPTION : Measures how long starting and stopping the watchdog takes:
+* WDStartEx until it returns, WDStartAsync until it returns and until the
+* watchdog reports it is up, and WDStopEx. Should be run like the test, from
+* a directory next to the watchdog executable.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h> /* printf */
+#include <time.h> /* clock_gettime, nanosleep */
+
+#include "watchdog.h"
+
+#define REPEATS (20)
+#define DOWNTIME_MS (1000)
+#define POLL_NS (50000L)
+#define NSEC_IN_SEC (1000000000.0)
+#define MSEC_IN_SEC (1000.0)
+
+static void OnReady(int status, void *param);
+static double Now(void);
+
+static volatile double g_ready_time = 0;
+static volatile int g_ready_status = -1;
+
+int main(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    struct timespec poll = {0, POLL_NS};
+    double sync_start = 0, async_return = 0, async_ready = 0, stop = 0;
+    int repeat = 0;
+
+    options.downtime_ms = DOWNTIME_MS;
+
+    for (repeat = 0; repeat < REPEATS; ++repeat)
+    {
+        double start = Now();
+
+        if (WDStartEx(argc, argv, &options))
+        {
+            printf("WDStartEx failed\n");
+            return (1);
+        }
+
+        sync_start += Now() - start;
+
+        start = Now();
+        WDStopEx(DOWNTIME_MS);
+        stop += Now() - start;
+
+        g_ready_status = -1;
+        start = Now();
+
+        if (WDStartAsync(argc, argv, &options, OnReady, NULL))
+        {
+            printf("WDStartAsync failed\n");
+            return (1);
+        }
+
+        async_return += Now() - start;
+
+        while (-1 == g_ready_status)
+        {
+            nanosleep(&poll, NULL);
+        }
+
+        if (0 != g_ready_status)
+        {
+            printf("the watchdog didn't come up\n");
+        }
+
+        async_ready += g_ready_time - start;
+
+        WDStopEx(DOWNTIME_MS);
+    }
+
+    printf("%-24s %10s\n", "", "ms");
+    printf("%-24s %10.2f\n", "WDStartEx", sync_start * MSEC_IN_SEC / REPEATS);
+    printf("%-24s %10.2f\n", "WDStartAsync returned",
+                                        async_return * MSEC_IN_SEC / REPEATS);
+    printf("%-24s %10.2f\n", "WDStartAsync ready",
+                                        async_ready * MSEC_IN_SEC / REPEATS);
+    printf("%-24s %10.2f\n", "WDStopEx", stop * MSEC_IN_SEC / REPEATS);
+
+    return (0);
+}
+
+static void OnReady(int status, void *param)
+{
+    g_ready_time = Now();
+    g_ready_status = status;
+
+    (void)param;
+}
+
+static double Now(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec + now.tv_nsec / NSEC_IN_SEC);
+}
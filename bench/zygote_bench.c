@@ -0,0 +1,203 @@
+/*******************************************************************************
+*
+* FILENAME : zygote_bench.c
+*
+* DESCRIPTION : Measures how long a crashed program takes to be ready again,
+* from the moment the watchdog notices the crash, when it is restarted by
+* exec and when it is forked by the zygote. The program builds an index
+* before it is ready, like a program that loads its data on startup, and
+* crashes right after. Run it with "exec" or "zygote" like the test, from a
+* directory next to the watchdog executable. It waits for the last restart.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h> /* printf, fdopen */
+#include <stdlib.h> /* malloc, qsort */
+#include <string.h> /* strcmp */
+#include <time.h> /* clock_gettime */
+#include <unistd.h> /* fork, execv, pipe */
+#include <sys/wait.h> /* waitpid */
+
+#include "watchdog.h"
+
+#define REPEATS (10)
+#define DOWNTIME_MS (1000)
+#define INDEX_SIZE (4000000UL)
+#define NSEC_IN_SEC (1000000000.0)
+#define MSEC_IN_SEC (1000.0)
+#define ARG_SIZE (24)
+
+static int Launch(char *path, char *mode);
+static int Run(int argc, char *argv[]);
+static void BuildIndex(void);
+static int CompareKeys(const void *key1, const void *key2);
+static double Now(void);
+
+int main(int argc, char *argv[])
+{
+    if (3 == argc)
+    {
+        return (Run(argc, argv));
+    }
+
+    return (Launch(argv[0], (1 < argc) ? argv[1] : "exec"));
+}
+
+/* every instance of the program, the watchdog and the zygote inherit the
+   pipe, so it is closed once they all have exited */
+static int Launch(char *path, char *mode)
+{
+    char fd_str[ARG_SIZE] = {0};
+    char *args[4] = {NULL};
+    double latency = 0, sum = 0, max = 0;
+    size_t amount = 0;
+    FILE *results = NULL;
+    int fds[2] = {0};
+    pid_t pid = 0;
+
+    if (0 != pipe(fds))
+    {
+        return (1);
+    }
+
+    sprintf(fd_str, "%d", fds[1]);
+
+    args[0] = path;
+    args[1] = mode;
+    args[2] = fd_str;
+
+    pid = fork();
+    if (0 == pid)
+    {
+        close(fds[0]);
+        execv(path, args);
+        _exit(1);
+    }
+
+    close(fds[1]);
+
+    results = fdopen(fds[0], "r");
+    if (NULL == results)
+    {
+        return (1);
+    }
+
+    while (1 == fscanf(results, "%lf", &latency))
+    {
+        sum += latency;
+        max = (max < latency) ? latency : max;
+        ++amount;
+    }
+
+    fclose(results);
+    waitpid(pid, NULL, 0);
+
+    if (0 == amount)
+    {
+        printf("no restarts measured\n");
+        return (1);
+    }
+
+    printf("%-8s %10s %12s %12s\n", "restart", "restarts", "mean ms",
+                                                                    "max ms");
+    printf("%-8s %10lu %12.2f %12.2f\n", mode, (unsigned long)amount,
+                        sum * MSEC_IN_SEC / amount, max * MSEC_IN_SEC);
+
+    return (0);
+}
+
+static int Run(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    char line[ARG_SIZE] = {0};
+    int is_zygote = (0 == strcmp(argv[1], "zygote"));
+    int results = (int)strtol(argv[2], NULL, 10);
+    size_t amount = 0;
+    double ready = 0;
+
+    options.downtime_ms = DOWNTIME_MS;
+
+    if (WDStartEx(argc, argv, &options))
+    {
+        printf("WDStartEx failed\n");
+        return (1);
+    }
+
+    BuildIndex();
+
+    if (is_zygote && WDForkPoint(NULL))
+    {
+        printf("WDForkPoint failed\n");
+    }
+
+    ready = Now();
+
+    /* the history is the only thing the instances have in common */
+    amount = WDGetRestartHistory(records, WD_HISTORY_SIZE);
+
+    if (0 != amount)
+    {
+        const struct timespec *exit_time = &records[amount - 1].exit_time;
+
+        sprintf(line, "%f\n", ready - (exit_time->tv_sec
+                                       + exit_time->tv_nsec / NSEC_IN_SEC));
+        write(results, line, strlen(line));
+    }
+
+    if (amount < REPEATS)
+    {
+        _exit(1);
+    }
+
+    WDStop();
+
+    return (0);
+}
+
+/* stands for the initialization the zygote saves */
+static void BuildIndex(void)
+{
+    unsigned int *keys = (unsigned int *)malloc(INDEX_SIZE
+                                                * sizeof(unsigned int));
+    unsigned int seed = 1;
+    size_t i = 0;
+
+    if (NULL == keys)
+    {
+        return;
+    }
+
+    for (i = 0; i < INDEX_SIZE; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        keys[i] = seed;
+    }
+
+    qsort(keys, INDEX_SIZE, sizeof(unsigned int), CompareKeys);
+
+    free(keys);
+}
+
+static int CompareKeys(const void *key1, const void *key2)
+{
+    unsigned int left = *(const unsigned int *)key1;
+    unsigned int right = *(const unsigned int *)key2;
+
+    return ((left > right) - (left < right));
+}
+
+static double Now(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    return (now.tv_sec + now.tv_nsec / NSEC_IN_SEC);
+}
@@ -0,0 +1,302 @@
+/*******************************************************************************
+*
+* FILENAME : hash_table.c
+*
+* DESCRIPTION : Hash table implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#include <assert.h> /* assert */
+#include <limits.h> /* CHAR_BIT, ULONG_MAX */
+#include <stdlib.h> /* calloc, free */
+
+#include "hash_table.h"
+
+#define DEFAULT_CAPACITY (16)
+#define GROWTH_FACTOR (2)
+#define MAX_LOAD_NUMERATOR (1)
+#define MAX_LOAD_DENOMINATOR (2)
+
+/* 2^w / golden ratio, odd, so multiplying by it is a bijection */
+#if ULONG_MAX > 0xFFFFFFFFUL
+#define GOLDEN_RATIO (0x9E3779B97F4A7C15UL)
+#else
+#define GOLDEN_RATIO (0x9E3779B9UL)
+#endif
+
+enum {SUCCESS, FAILURE};
+
+typedef struct hash_entry
+{
+    size_t hash;
+    void *data;
+} hash_entry_t;
+
+struct hash_table
+{
+    hash_entry_t *entries;
+    size_t size;
+    size_t capacity;
+    hash_table_hash_func_t hash;
+    hash_table_is_match_func_t is_match;
+};
+
+static int GrowIfNeeded(hash_table_t *table);
+static void PlaceEntry(hash_entry_t *entries, size_t mask, hash_entry_t entry);
+static size_t FindIndex(const hash_table_t *table, void *key);
+static void RemoveAt(hash_table_t *table, size_t index);
+static size_t RoundUpToPowerOfTwo(size_t n);
+static size_t MixHash(size_t hash);
+
+hash_table_t *HashTableCreate(hash_table_hash_func_t hash,
+                              hash_table_is_match_func_t is_match,
+                              size_t capacity)
+{
+    hash_table_t *new_table = NULL;
+
+    assert(NULL != hash);
+    assert(NULL != is_match);
+
+    if (0 == capacity)
+    {
+        capacity = DEFAULT_CAPACITY;
+    }
+
+    capacity = RoundUpToPowerOfTwo(capacity * MAX_LOAD_DENOMINATOR);
+
+    new_table = (hash_table_t *) malloc(sizeof(hash_table_t));
+    if (NULL == new_table)
+    {
+        return (NULL);
+    }
+
+    new_table->entries = (hash_entry_t *) calloc(capacity,
+                                                 sizeof(hash_entry_t));
+    if (NULL == new_table->entries)
+    {
+        free(new_table);
+        new_table = NULL;
+
+        return (NULL);
+    }
+
+    new_table->size = 0;
+    new_table->capacity = capacity;
+    new_table->hash = hash;
+    new_table->is_match = is_match;
+
+    return (new_table);
+}
+
+void HashTableDestroy(hash_table_t *table)
+{
+    assert(NULL != table);
+
+    free(table->entries);
+    table->entries = NULL;
+
+    free(table);
+    table = NULL;
+}
+
+int HashTableInsert(hash_table_t *table, void *key, void *data)
+{
+    hash_entry_t entry = {0};
+
+    assert(NULL != table);
+    assert(NULL != data);
+
+    if (SUCCESS != GrowIfNeeded(table))
+    {
+        return (FAILURE);
+    }
+
+    entry.hash = MixHash(table->hash(key));
+    entry.data = data;
+
+    PlaceEntry(table->entries, table->capacity - 1, entry);
+    ++table->size;
+
+    return (SUCCESS);
+}
+
+void *HashTableRemove(hash_table_t *table, void *key)
+{
+    size_t index = 0;
+    void *removed_data = NULL;
+
+    assert(NULL != table);
+
+    index = FindIndex(table, key);
+    if (table->capacity == index)
+    {
+        return (NULL);
+    }
+
+    removed_data = table->entries[index].data;
+    RemoveAt(table, index);
+
+    return (removed_data);
+}
+
+void *HashTableFind(const hash_table_t *table, void *key)
+{
+    size_t index = 0;
+
+    assert(NULL != table);
+
+    index = FindIndex(table, key);
+    if (table->capacity == index)
+    {
+        return (NULL);
+    }
+
+    return (table->entries[index].data);
+}
+
+size_t HashTableSize(const hash_table_t *table)
+{
+    assert(NULL != table);
+
+    return (table->size);
+}
+
+int HashTableIsEmpty(const hash_table_t *table)
+{
+    assert(NULL != table);
+
+    return (0 == table->size);
+}
+
+void HashTableClear(hash_table_t *table)
+{
+    size_t i = 0;
+
+    assert(NULL != table);
+
+    for (i = 0; i < table->capacity; ++i)
+    {
+        table->entries[i].data = NULL;
+    }
+
+    table->size = 0;
+}
+
+static int GrowIfNeeded(hash_table_t *table)
+{
+    hash_entry_t *new_entries = NULL;
+    size_t new_capacity = 0;
+    size_t i = 0;
+
+    assert(NULL != table);
+
+    if ((table->size + 1) * MAX_LOAD_DENOMINATOR
+                                    <= table->capacity * MAX_LOAD_NUMERATOR)
+    {
+        return (SUCCESS);
+    }
+
+    new_capacity = table->capacity * GROWTH_FACTOR;
+
+    new_entries = (hash_entry_t *) calloc(new_capacity, sizeof(hash_entry_t));
+    if (NULL == new_entries)
+    {
+        return (FAILURE);
+    }
+
+    for (i = 0; i < table->capacity; ++i)
+    {
+        if (NULL != table->entries[i].data)
+        {
+            PlaceEntry(new_entries, new_capacity - 1, table->entries[i]);
+        }
+    }
+
+    free(table->entries);
+    table->entries = new_entries;
+    table->capacity = new_capacity;
+
+    return (SUCCESS);
+}
+
+static void PlaceEntry(hash_entry_t *entries, size_t mask, hash_entry_t entry)
+{
+    size_t index = entry.hash & mask;
+
+    while (NULL != entries[index].data)
+    {
+        index = (index + 1) & mask;
+    }
+
+    entries[index] = entry;
+}
+
+static size_t FindIndex(const hash_table_t *table, void *key)
+{
+    size_t mask = table->capacity - 1;
+    size_t hash = MixHash(table->hash(key));
+    size_t index = hash & mask;
+
+    while (NULL != table->entries[index].data)
+    {
+        if (hash == table->entries[index].hash
+         && table->is_match(table->entries[index].data, key))
+        {
+            return (index);
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    return (table->capacity);
+}
+
+static void RemoveAt(hash_table_t *table, size_t index)
+{
+    hash_entry_t *entries = table->entries;
+    size_t mask = table->capacity - 1;
+    size_t next = (index + 1) & mask;
+
+    /* backward shift deletion keeps probe sequences without tombstones */
+    while (NULL != entries[next].data)
+    {
+        size_t home = entries[next].hash & mask;
+
+        if (((next - home) & mask) >= ((next - index) & mask))
+        {
+            entries[index] = entries[next];
+            index = next;
+        }
+
+        next = (next + 1) & mask;
+    }
+
+    entries[index].data = NULL;
+    --table->size;
+}
+
+static size_t RoundUpToPowerOfTwo(size_t n)
+{
+    size_t result = 1;
+
+    while (result < n)
+    {
+        result <<= 1;
+    }
+
+    return (result);
+}
+
+/* the user's hash is masked by the low bits only, so sequential keys (like
+   counters) would fill one long probe run; fold the well mixed high bits of
+   the product down to spread them over the whole table */
+static size_t MixHash(size_t hash)
+{
+    hash *= (size_t)GOLDEN_RATIO;
+
+    return (hash ^ (hash >> (sizeof(size_t) * CHAR_BIT / 2)));
+}
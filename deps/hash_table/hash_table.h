@@ -0,0 +1,163 @@
+/*******************************************************************************
+*
+* FILENAME : hash_table.h
+*
+* DESCRIPTION : Hash table is an abstract data type that maps keys to values.
+* It uses a hash function to compute an index into an array of slots, from
+* which the desired value can be found. This hash table uses open addressing
+* with linear probing, so all the elements are kept in one contiguous array.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_HASH_TABLE_H__
+#define __NSRD_HASH_TABLE_H__
+
+#include <stddef.h> /* size_t */
+
+typedef struct hash_table hash_table_t;
+
+/*
+DESCRIPTION
+    Pointer to the user's function that computes the hash of the key.
+    Equal keys should produce equal hashes. The table mixes the hash
+    before using it, so sequential hashes (like counters) are fine.
+RETURN
+    Hash of the key.
+INPUT
+    key: pointer to the user's key.
+*/
+typedef size_t (*hash_table_hash_func_t)(const void *key);
+
+/*
+DESCRIPTION
+    Pointer to the user's function that checks if the data is stored under
+    the key. The actual matching and types of the input are defined by the
+    user.
+RETURN
+    1: matches.
+    0: not matches.
+INPUT
+    data: pointer to the user's data.
+    key: pointer to the user's key.
+*/
+typedef int (*hash_table_is_match_func_t)(const void *data, void *key);
+
+/*
+DESCRIPTION
+    Creates new hash table. The table grows on demand.
+    Creation may fail, due to memory allocation fail.
+    User is responsible for memory deallocation.
+RETURN
+    Pointer to the created hash table on success.
+    NULL if allocation failed.
+INPUT
+    hash: pointer to the hash function.
+    is_match: pointer to the function that matches the data with the key.
+    capacity: number of elements to reserve the storage for. 0 - default.
+TIME COMPLEXITY:
+    O(capacity)
+*/
+hash_table_t *HashTableCreate(hash_table_hash_func_t hash,
+                              hash_table_is_match_func_t is_match,
+                              size_t capacity);
+
+/*
+DESCRIPTION
+    Frees the memory allocated for the hash table. The user's data is not
+    freed.
+RETURN
+    Doesn't return anything.
+INPUT
+    table: pointer to the hash table.
+TIME COMPLEXITY:
+    O(1)
+*/
+void HashTableDestroy(hash_table_t *table);
+
+/*
+DESCRIPTION
+    Inserts the data under the key. Inserting the key which is already in
+    the table is undefined behavior. Data can't be NULL.
+    Insertion may fail, due to memory allocation fail when the table grows.
+RETURN
+    0: success.
+    1: fail.
+INPUT
+    table: pointer to the hash table.
+    key: pointer to the user's key.
+    data: pointer to the user's data.
+TIME COMPLEXITY:
+    O(1) amortized
+*/
+int HashTableInsert(hash_table_t *table, void *key, void *data);
+
+/*
+DESCRIPTION
+    Removes the data stored under the key.
+RETURN
+    Pointer to the removed data on success.
+    NULL if the key wasn't found.
+INPUT
+    table: pointer to the hash table.
+    key: pointer to the user's key.
+TIME COMPLEXITY:
+    O(1) average
+*/
+void *HashTableRemove(hash_table_t *table, void *key);
+
+/*
+DESCRIPTION
+    Finds the data stored under the key.
+RETURN
+    Pointer to the data on success.
+    NULL if the key wasn't found.
+INPUT
+    table: pointer to the hash table.
+    key: pointer to the user's key.
+TIME COMPLEXITY:
+    O(1) average
+*/
+void *HashTableFind(const hash_table_t *table, void *key);
+
+/*
+DESCRIPTION
+    Returns the amount of elements in the hash table.
+RETURN
+    Number of elements in the hash table.
+INPUT
+    table: pointer to the hash table.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t HashTableSize(const hash_table_t *table);
+
+/*
+DESCRIPTION
+    Checks if the hash table is empty.
+RETURN
+    1: empty.
+    0: is not empty.
+INPUT
+    table: pointer to the hash table.
+TIME COMPLEXITY:
+    O(1)
+*/
+int HashTableIsEmpty(const hash_table_t *table);
+
+/*
+DESCRIPTION
+    Removes all elements from the hash table. The storage is kept for reuse.
+RETURN
+    Doesn't return anything.
+INPUT
+    table: pointer to the hash table.
+TIME COMPLEXITY:
+    O(capacity)
+*/
+void HashTableClear(hash_table_t *table);
+
+#endif  /* __NSRD_HASH_TABLE_H__ */
@@ -0,0 +1,144 @@
+/*******************************************************************************
+*
+* FILENAME : hash_table_test.c
+*
+* DESCRIPTION : Hash table unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#include "hash_table.h"
+#include "testing.h"
+
+#define ELEMENTS_AMOUNT (1000)
+#define COLLIDING_BUCKETS (7)
+
+static size_t HashInt(const void *key);
+static size_t HashIntColliding(const void *key);
+static int IsSameInt(const void *data, void *key);
+
+static void TestHashTableGeneral(void);
+static void TestHashTableGrow(void);
+static void TestHashTableCollisions(void);
+
+int main()
+{
+	TH_TEST_T TESTS[] = {
+		{"General", TestHashTableGeneral},
+		{"Grow", TestHashTableGrow},
+		{"Collisions", TestHashTableCollisions},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(TESTS);
+
+	return (0);
+}
+
+static void TestHashTableGeneral(void)
+{
+	int arr[3] = {10, 20, 30};
+	int not_in_table = 40;
+
+	hash_table_t *table = HashTableCreate(HashInt, IsSameInt, 0);
+
+	TH_ASSERT(NULL != table);
+	TH_ASSERT(1 == HashTableIsEmpty(table));
+
+	TH_ASSERT(0 == HashTableInsert(table, arr, arr));
+	TH_ASSERT(0 == HashTableInsert(table, arr + 1, arr + 1));
+	TH_ASSERT(0 == HashTableInsert(table, arr + 2, arr + 2));
+	TH_ASSERT(3 == HashTableSize(table));
+
+	TH_ASSERT(arr + 1 == HashTableFind(table, arr + 1));
+	TH_ASSERT(NULL == HashTableFind(table, &not_in_table));
+
+	TH_ASSERT(arr + 1 == HashTableRemove(table, arr + 1));
+	TH_ASSERT(NULL == HashTableFind(table, arr + 1));
+	TH_ASSERT(NULL == HashTableRemove(table, arr + 1));
+	TH_ASSERT(2 == HashTableSize(table));
+
+	HashTableClear(table);
+	TH_ASSERT(1 == HashTableIsEmpty(table));
+	TH_ASSERT(NULL == HashTableFind(table, arr));
+
+	HashTableDestroy(table);
+}
+
+static void TestHashTableGrow(void)
+{
+	int arr[ELEMENTS_AMOUNT] = {0};
+	size_t i = 0;
+	int is_found = 1;
+
+	hash_table_t *table = HashTableCreate(HashInt, IsSameInt, 1);
+
+	for (i = 0; i < ELEMENTS_AMOUNT; ++i)
+	{
+		arr[i] = (int)i;
+		TH_ASSERT(0 == HashTableInsert(table, arr + i, arr + i));
+	}
+
+	TH_ASSERT(ELEMENTS_AMOUNT == HashTableSize(table));
+
+	for (i = 0; i < ELEMENTS_AMOUNT; ++i)
+	{
+		is_found &= (arr + i == HashTableFind(table, arr + i));
+	}
+
+	TH_ASSERT(is_found);
+
+	HashTableDestroy(table);
+}
+
+static void TestHashTableCollisions(void)
+{
+	int arr[ELEMENTS_AMOUNT] = {0};
+	size_t i = 0;
+	int is_found = 1;
+	int is_removed = 1;
+
+	hash_table_t *table = HashTableCreate(HashIntColliding, IsSameInt, 0);
+
+	for (i = 0; i < ELEMENTS_AMOUNT; ++i)
+	{
+		arr[i] = (int)i;
+		HashTableInsert(table, arr + i, arr + i);
+	}
+
+	for (i = 0; i < ELEMENTS_AMOUNT; i += 2)
+	{
+		is_removed &= (arr + i == HashTableRemove(table, arr + i));
+	}
+
+	TH_ASSERT(is_removed);
+	TH_ASSERT(ELEMENTS_AMOUNT / 2 == HashTableSize(table));
+
+	for (i = 0; i < ELEMENTS_AMOUNT; ++i)
+	{
+		void *expected = (0 == i % 2) ? NULL : arr + i;
+		is_found &= (expected == HashTableFind(table, arr + i));
+	}
+
+	TH_ASSERT(is_found);
+
+	HashTableDestroy(table);
+}
+
+static size_t HashInt(const void *key)
+{
+	return ((size_t)*(int *)key);
+}
+
+static size_t HashIntColliding(const void *key)
+{
+	return ((size_t)*(int *)key % COLLIDING_BUCKETS);
+}
+
+static int IsSameInt(const void *data, void *key)
+{
+	return (*(int *)data == *(int *)key);
+}
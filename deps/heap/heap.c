@@ -0,0 +1,296 @@
+/*******************************************************************************
+*
+* FILENAME : heap.c
+*
+* DESCRIPTION : Binary heap implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#include <assert.h> /* assert */
+#include <stdlib.h> /* malloc, realloc, free */
+
+#include "heap.h"
+
+#define DEFAULT_CAPACITY (16)
+#define GROWTH_FACTOR (2)
+
+#define PARENT(i) (((i) - 1) / 2)
+#define LEFT_CHILD(i) (2 * (i) + 1)
+#define RIGHT_CHILD(i) (2 * (i) + 2)
+
+enum {SUCCESS, FAILURE};
+
+struct heap
+{
+    void **arr;
+    size_t size;
+    size_t capacity;
+    heap_compare_func_t compare;
+    heap_set_index_func_t set_index;
+};
+
+static int GrowIfFull(heap_t *heap);
+static void HeapifyUp(heap_t *heap, size_t index);
+static void HeapifyDown(heap_t *heap, size_t index);
+static void *RemoveAt(heap_t *heap, size_t index);
+static void Place(heap_t *heap, size_t index, void *data);
+static void Swap(heap_t *heap, size_t i, size_t j);
+
+heap_t *HeapCreate(heap_compare_func_t compare, size_t capacity)
+{
+    heap_t *new_heap = NULL;
+
+    assert(NULL != compare);
+
+    if (0 == capacity)
+    {
+        capacity = DEFAULT_CAPACITY;
+    }
+
+    new_heap = (heap_t *) malloc(sizeof(heap_t));
+    if (NULL == new_heap)
+    {
+        return (NULL);
+    }
+
+    new_heap->arr = (void **) malloc(capacity * sizeof(void *));
+    if (NULL == new_heap->arr)
+    {
+        free(new_heap);
+        new_heap = NULL;
+
+        return (NULL);
+    }
+
+    new_heap->size = 0;
+    new_heap->capacity = capacity;
+    new_heap->compare = compare;
+    new_heap->set_index = NULL;
+
+    return (new_heap);
+}
+
+void HeapDestroy(heap_t *heap)
+{
+    assert(NULL != heap);
+
+    free(heap->arr);
+    heap->arr = NULL;
+
+    free(heap);
+    heap = NULL;
+}
+
+int HeapPush(heap_t *heap, void *data)
+{
+    assert(NULL != heap);
+
+    if (SUCCESS != GrowIfFull(heap))
+    {
+        return (FAILURE);
+    }
+
+    Place(heap, heap->size, data);
+    ++heap->size;
+
+    HeapifyUp(heap, heap->size - 1);
+
+    return (SUCCESS);
+}
+
+void *HeapPop(heap_t *heap)
+{
+    assert(NULL != heap);
+    assert(0 < heap->size);
+
+    return (RemoveAt(heap, 0));
+}
+
+void *HeapPeek(const heap_t *heap)
+{
+    assert(NULL != heap);
+    assert(0 < heap->size);
+
+    return (heap->arr[0]);
+}
+
+void *HeapRemove(heap_t *heap, heap_is_match_func_t is_match, void *param)
+{
+    size_t i = 0;
+
+    assert(NULL != heap);
+    assert(NULL != is_match);
+
+    for (i = 0; i < heap->size; ++i)
+    {
+        if (is_match(heap->arr[i], param))
+        {
+            return (RemoveAt(heap, i));
+        }
+    }
+
+    return (NULL);
+}
+
+void *HeapRemoveAt(heap_t *heap, size_t index)
+{
+    assert(NULL != heap);
+    assert(index < heap->size);
+
+    return (RemoveAt(heap, index));
+}
+
+void HeapSetIndexFunc(heap_t *heap, heap_set_index_func_t set_index)
+{
+    assert(NULL != heap);
+
+    heap->set_index = set_index;
+}
+
+size_t HeapSize(const heap_t *heap)
+{
+    assert(NULL != heap);
+
+    return (heap->size);
+}
+
+int HeapIsEmpty(const heap_t *heap)
+{
+    assert(NULL != heap);
+
+    return (0 == heap->size);
+}
+
+void HeapClear(heap_t *heap)
+{
+    assert(NULL != heap);
+
+    if (NULL != heap->set_index)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < heap->size; ++i)
+        {
+            heap->set_index(heap->arr[i], HEAP_NO_INDEX);
+        }
+    }
+
+    heap->size = 0;
+}
+
+static int GrowIfFull(heap_t *heap)
+{
+    void **new_arr = NULL;
+    size_t new_capacity = 0;
+
+    assert(NULL != heap);
+
+    if (heap->size < heap->capacity)
+    {
+        return (SUCCESS);
+    }
+
+    new_capacity = heap->capacity * GROWTH_FACTOR;
+
+    new_arr = (void **) realloc(heap->arr, new_capacity * sizeof(void *));
+    if (NULL == new_arr)
+    {
+        return (FAILURE);
+    }
+
+    heap->arr = new_arr;
+    heap->capacity = new_capacity;
+
+    return (SUCCESS);
+}
+
+static void *RemoveAt(heap_t *heap, size_t index)
+{
+    void *removed_data = NULL;
+
+    assert(NULL != heap);
+    assert(index < heap->size);
+
+    removed_data = heap->arr[index];
+
+    if (NULL != heap->set_index)
+    {
+        heap->set_index(removed_data, HEAP_NO_INDEX);
+    }
+
+    --heap->size;
+
+    if (index != heap->size)
+    {
+        Place(heap, index, heap->arr[heap->size]);
+
+        HeapifyUp(heap, index);
+        HeapifyDown(heap, index);
+    }
+
+    return (removed_data);
+}
+
+static void HeapifyUp(heap_t *heap, size_t index)
+{
+    void **arr = heap->arr;
+
+    while (0 < index && 0 < heap->compare(arr[index], arr[PARENT(index)]))
+    {
+        Swap(heap, index, PARENT(index));
+        index = PARENT(index);
+    }
+}
+
+static void HeapifyDown(heap_t *heap, size_t index)
+{
+    void **arr = heap->arr;
+    size_t size = heap->size;
+    size_t largest = index;
+
+    for (;;)
+    {
+        size_t left = LEFT_CHILD(index);
+        size_t right = RIGHT_CHILD(index);
+
+        if (left < size && 0 < heap->compare(arr[left], arr[largest]))
+        {
+            largest = left;
+        }
+
+        if (right < size && 0 < heap->compare(arr[right], arr[largest]))
+        {
+            largest = right;
+        }
+
+        if (largest == index)
+        {
+            break;
+        }
+
+        Swap(heap, index, largest);
+        index = largest;
+    }
+}
+
+static void Place(heap_t *heap, size_t index, void *data)
+{
+    heap->arr[index] = data;
+
+    if (NULL != heap->set_index)
+    {
+        heap->set_index(data, index);
+    }
+}
+
+static void Swap(heap_t *heap, size_t i, size_t j)
+{
+    void *tmp = heap->arr[i];
+
+    Place(heap, i, heap->arr[j]);
+    Place(heap, j, tmp);
+}
@@ -0,0 +1,219 @@
+/*******************************************************************************
+*
+* FILENAME : heap.h
+*
+* DESCRIPTION : Binary heap is a complete binary tree, stored in a contiguous
+* array, in which every element has higher or equal priority than its
+* children. The element with the highest priority is always at the root.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_HEAP_H__
+#define __NSRD_HEAP_H__
+
+#include <stddef.h> /* size_t */
+
+typedef struct heap heap_t;
+
+/* index reported for the element that left the heap */
+#define HEAP_NO_INDEX ((size_t)-1)
+
+/*
+DESCRIPTION
+    Pointer to the user's function that compares data1 and data2.
+    The actual matching and types of the input are defined by the user.
+    The element that is the largest according to this function is the root.
+RETURN
+    Positive: data1 > data2.
+    Negative: data1 < data2.
+    0: data1 == data2.
+INPUT
+    data1: pointer to the user's data.
+    data2: pointer to the user's data.
+*/
+typedef int (*heap_compare_func_t)(const void *data1, const void *data2);
+
+/*
+DESCRIPTION
+    Pointer to the user's function that compares if the data matches a certain
+    criteria, using the param. The actual matching and types of the input are
+    defined by the user.
+RETURN
+    1: matches.
+    0: not matches.
+INPUT
+    data: pointer to the user's data.
+    param: pointer to the parameter.
+*/
+typedef int (*heap_is_match_func_t)(const void *data, void *param);
+
+/*
+DESCRIPTION
+    Pointer to the user's function that is told the current index of the data
+    in the heap every time the data is moved. The index can be stored in the
+    data itself and later passed to HeapRemoveAt.
+RETURN
+    Doesn't return anything.
+INPUT
+    data: pointer to the user's data.
+    index: new index of the data, HEAP_NO_INDEX when it leaves the heap.
+*/
+typedef void (*heap_set_index_func_t)(void *data, size_t index);
+
+/*
+DESCRIPTION
+    Creates new binary heap. The heap will order elements based on the user's
+    compare function - "compare". The storage grows on demand.
+    Creation may fail, due to memory allocation fail.
+    User is responsible for memory deallocation.
+RETURN
+    Pointer to the created heap on success.
+    NULL if allocation failed.
+INPUT
+    compare: pointer to the compare function.
+    capacity: number of elements to reserve the storage for. 0 - default.
+TIME COMPLEXITY:
+    O(1)
+*/
+heap_t *HeapCreate(heap_compare_func_t compare, size_t capacity);
+
+/*
+DESCRIPTION
+    Frees the memory allocated for the heap. The user's data is not freed.
+RETURN
+    Doesn't return anything.
+INPUT
+    heap: pointer to the heap.
+TIME COMPLEXITY:
+    O(1)
+*/
+void HeapDestroy(heap_t *heap);
+
+/*
+DESCRIPTION
+    Inserts a new element to the heap. Push may fail, due to memory
+    allocation fail when the storage has to grow.
+RETURN
+    0: success.
+    1: fail.
+INPUT
+    heap: pointer to the heap.
+    data: pointer to the user's data.
+TIME COMPLEXITY:
+    O(log n) amortized
+*/
+int HeapPush(heap_t *heap, void *data);
+
+/*
+DESCRIPTION
+    Removes the element with the highest priority.
+    Trying to pop empty heap may cause undefined behavior.
+RETURN
+    Pointer to user's data of removed element.
+INPUT
+    heap: pointer to the heap.
+TIME COMPLEXITY:
+    O(log n)
+*/
+void *HeapPop(heap_t *heap);
+
+/*
+DESCRIPTION
+    Gets data of the element with the highest priority.
+    Trying to peek empty heap is undefined behavior.
+RETURN
+    Pointer to user's data of the highest priority element.
+INPUT
+    heap: pointer to the heap.
+TIME COMPLEXITY:
+    O(1)
+*/
+void *HeapPeek(const heap_t *heap);
+
+/*
+DESCRIPTION
+    Traverses the heap for element that satisfies is_match function's
+    criteria. Removes the first occurance.
+RETURN
+    Pointer to user's data of removed element on success.
+    NULL if nothing found.
+INPUT
+    heap: pointer to the heap.
+    is_match: user's function that compares if the data matches a certain
+    criteria.
+    param: a parameter for the is_match function.
+TIME COMPLEXITY:
+    O(n)
+*/
+void *HeapRemove(heap_t *heap, heap_is_match_func_t is_match, void *param);
+
+/*
+DESCRIPTION
+    Removes the element on the passed index. Index must be lower than the size
+    of the heap, elements' indexes are reported by the set_index function.
+RETURN
+    Pointer to user's data of removed element.
+INPUT
+    heap: pointer to the heap.
+    index: index of the element.
+TIME COMPLEXITY:
+    O(log n)
+*/
+void *HeapRemoveAt(heap_t *heap, size_t index);
+
+/*
+DESCRIPTION
+    Sets the function that tracks the indexes of the elements. Should be set
+    while the heap is empty. NULL disables tracking.
+RETURN
+    Doesn't return anything.
+INPUT
+    heap: pointer to the heap.
+    set_index: user's function that receives the indexes.
+TIME COMPLEXITY:
+    O(1)
+*/
+void HeapSetIndexFunc(heap_t *heap, heap_set_index_func_t set_index);
+
+/*
+DESCRIPTION
+    Returns the amount of elements in the heap.
+RETURN
+    Number of elements in the heap.
+INPUT
+    heap: pointer to the heap.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t HeapSize(const heap_t *heap);
+
+/*
+DESCRIPTION
+    Checks if the heap is empty.
+RETURN
+    1: empty.
+    0: is not empty.
+INPUT
+    heap: pointer to the heap.
+TIME COMPLEXITY:
+    O(1)
+*/
+int HeapIsEmpty(const heap_t *heap);
+
+/*
+DESCRIPTION
+    Removes all elements from the heap. The storage is kept for reuse.
+RETURN
+    Doesn't return anything.
+INPUT
+    heap: pointer to the heap.
+TIME COMPLEXITY:
+    O(1), O(n) if indexes are tracked
+*/
+void HeapClear(heap_t *heap);
+
+#endif  /* __NSRD_HEAP_H__ */
@@ -0,0 +1,252 @@
+/*******************************************************************************
+*
+* FILENAME : heap_test.c
+*
+* DESCRIPTION : Binary heap unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#include <stdlib.h> /* rand, srand */
+
+#include "heap.h"
+#include "testing.h"
+
+#define RANDOM_AMOUNT (1000)
+
+typedef struct indexed
+{
+	int value;
+	size_t index;
+} indexed_t;
+
+static int CompareInts(const void *data1, const void *data2);
+static int IsSameInt(const void *data, void *param);
+static int CompareIndexed(const void *data1, const void *data2);
+static void SetIndex(void *data, size_t index);
+
+static void TestHeapGeneral(void);
+static void TestHeapGrow(void);
+static void TestHeapRemove(void);
+static void TestHeapRandom(void);
+static void TestHeapRemoveAt(void);
+
+int main()
+{
+	TH_TEST_T TESTS[] = {
+		{"General", TestHeapGeneral},
+		{"Grow", TestHeapGrow},
+		{"Remove", TestHeapRemove},
+		{"Random", TestHeapRandom},
+		{"RemoveAt", TestHeapRemoveAt},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(TESTS);
+
+	return (0);
+}
+
+static void TestHeapGeneral(void)
+{
+	int arr[5] = {3, 1, 5, 2, 4};
+	size_t i = 0;
+
+	heap_t *heap = HeapCreate(CompareInts, 0);
+
+	TH_ASSERT(NULL != heap);
+	TH_ASSERT(1 == HeapIsEmpty(heap));
+	TH_ASSERT(0 == HeapSize(heap));
+
+	for (i = 0; i < 5; ++i)
+	{
+		TH_ASSERT(0 == HeapPush(heap, arr + i));
+	}
+
+	TH_ASSERT(5 == HeapSize(heap));
+	TH_ASSERT(5 == *(int *)HeapPeek(heap));
+
+	TH_ASSERT(5 == *(int *)HeapPop(heap));
+	TH_ASSERT(4 == *(int *)HeapPop(heap));
+	TH_ASSERT(3 == *(int *)HeapPeek(heap));
+	TH_ASSERT(3 == HeapSize(heap));
+
+	HeapClear(heap);
+	TH_ASSERT(1 == HeapIsEmpty(heap));
+
+	HeapDestroy(heap);
+}
+
+static void TestHeapGrow(void)
+{
+	int arr[100] = {0};
+	size_t i = 0;
+	int is_ordered = 1;
+
+	heap_t *heap = HeapCreate(CompareInts, 1);
+
+	for (i = 0; i < 100; ++i)
+	{
+		arr[i] = (int)i;
+		TH_ASSERT(0 == HeapPush(heap, arr + i));
+	}
+
+	TH_ASSERT(100 == HeapSize(heap));
+
+	for (i = 100; 0 < i; --i)
+	{
+		is_ordered &= ((int)i - 1 == *(int *)HeapPop(heap));
+	}
+
+	TH_ASSERT(is_ordered);
+	TH_ASSERT(1 == HeapIsEmpty(heap));
+
+	HeapDestroy(heap);
+}
+
+static void TestHeapRemove(void)
+{
+	int arr[6] = {10, 20, 30, 40, 50, 60};
+	int not_in_heap = 70;
+	size_t i = 0;
+
+	heap_t *heap = HeapCreate(CompareInts, 0);
+
+	for (i = 0; i < 6; ++i)
+	{
+		HeapPush(heap, arr + i);
+	}
+
+	TH_ASSERT(arr + 3 == HeapRemove(heap, IsSameInt, arr + 3));
+	TH_ASSERT(5 == HeapSize(heap));
+	TH_ASSERT(NULL == HeapRemove(heap, IsSameInt, &not_in_heap));
+	TH_ASSERT(5 == HeapSize(heap));
+
+	TH_ASSERT(arr + 5 == HeapRemove(heap, IsSameInt, arr + 5));
+	TH_ASSERT(50 == *(int *)HeapPeek(heap));
+
+	TH_ASSERT(50 == *(int *)HeapPop(heap));
+	TH_ASSERT(30 == *(int *)HeapPop(heap));
+	TH_ASSERT(20 == *(int *)HeapPop(heap));
+	TH_ASSERT(10 == *(int *)HeapPop(heap));
+	TH_ASSERT(1 == HeapIsEmpty(heap));
+
+	HeapDestroy(heap);
+}
+
+static void TestHeapRandom(void)
+{
+	int arr[RANDOM_AMOUNT] = {0};
+	size_t i = 0;
+	int prev = 0;
+	int is_ordered = 1;
+
+	heap_t *heap = HeapCreate(CompareInts, 0);
+
+	srand(RANDOM_AMOUNT);
+
+	for (i = 0; i < RANDOM_AMOUNT; ++i)
+	{
+		arr[i] = rand() % RANDOM_AMOUNT;
+		HeapPush(heap, arr + i);
+	}
+
+	for (i = 0; i < RANDOM_AMOUNT / 2; ++i)
+	{
+		HeapRemove(heap, IsSameInt, arr + i * 2);
+	}
+
+	TH_ASSERT(RANDOM_AMOUNT / 2 == HeapSize(heap));
+
+	prev = *(int *)HeapPop(heap);
+
+	while (!HeapIsEmpty(heap))
+	{
+		int curr = *(int *)HeapPop(heap);
+		is_ordered &= (curr <= prev);
+		prev = curr;
+	}
+
+	TH_ASSERT(is_ordered);
+
+	HeapDestroy(heap);
+}
+
+static void TestHeapRemoveAt(void)
+{
+	indexed_t arr[RANDOM_AMOUNT] = {{0}};
+	size_t i = 0;
+	int is_tracked = 1;
+	int prev = 0;
+	int is_ordered = 1;
+
+	heap_t *heap = HeapCreate(CompareIndexed, 0);
+	HeapSetIndexFunc(heap, SetIndex);
+
+	srand(RANDOM_AMOUNT);
+
+	for (i = 0; i < RANDOM_AMOUNT; ++i)
+	{
+		arr[i].value = rand() % RANDOM_AMOUNT;
+		HeapPush(heap, arr + i);
+	}
+
+	for (i = 0; i < RANDOM_AMOUNT; i += 2)
+	{
+		is_tracked &= (arr + i == HeapRemoveAt(heap, arr[i].index));
+		is_tracked &= (HEAP_NO_INDEX == arr[i].index);
+	}
+
+	TH_ASSERT(is_tracked);
+	TH_ASSERT(RANDOM_AMOUNT / 2 == HeapSize(heap));
+
+	prev = ((indexed_t *)HeapPop(heap))->value;
+
+	while (!HeapIsEmpty(heap))
+	{
+		int curr = ((indexed_t *)HeapPop(heap))->value;
+		is_ordered &= (curr <= prev);
+		prev = curr;
+	}
+
+	TH_ASSERT(is_ordered);
+
+	HeapPush(heap, arr + 1);
+	HeapClear(heap);
+	TH_ASSERT(HEAP_NO_INDEX == arr[1].index);
+
+	HeapDestroy(heap);
+}
+
+static int CompareIndexed(const void *data1, const void *data2)
+{
+	return (CompareInts(&((const indexed_t *)data1)->value,
+	                    &((const indexed_t *)data2)->value));
+}
+
+static void SetIndex(void *data, size_t index)
+{
+	((indexed_t *)data)->index = index;
+}
+
+static int CompareInts(const void *data1, const void *data2)
+{
+	if (*(int *) data1 < *(int *) data2)
+	{
+		return (-1);
+	}
+	else if (*(int *) data1 == *(int *) data2)
+	{
+		return (0);
+	}
+
+	return (1);
+}
+
+static int IsSameInt(const void *data, void *param)
+{
+	return (data == param);
+}
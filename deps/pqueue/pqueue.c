@@ -19,13 +19,23 @@ enum {SUCCESS, FAILURE};
 
 struct pq
 {
+    pq_backend_t backend;
     sorted_list_t *sorted_list;
+    heap_t *heap;
 };
 
+static int ListEnqueue(sorted_list_t *list, void *data);
+static void *ListErase(sorted_list_t *list, pqueue_is_match_func_t is_match,
+                                                                void *param);
+
 pq_t *PQCreate(pqueue_compare_func_t compare)
+{
+    return (PQCreateEx(compare, PQ_SORTED_LIST));
+}
+
+pq_t *PQCreateEx(pqueue_compare_func_t compare, pq_backend_t backend)
 {
     pq_t *new_pqueue = NULL;
-    sorted_list_t *new_list = NULL;
 
     assert(NULL != compare);
 
@@ -35,26 +45,43 @@ pq_t *PQCreate(pqueue_compare_func_t compare)
         return (NULL);
     }
 
-    new_list = SortedListCreate(compare);
-    if (NULL == new_list)
+    new_pqueue->backend = backend;
+    new_pqueue->sorted_list = NULL;
+    new_pqueue->heap = NULL;
+
+    if (PQ_HEAP == backend)
+    {
+        new_pqueue->heap = HeapCreate(compare, 0);
+    }
+    else
+    {
+        new_pqueue->sorted_list = SortedListCreate(compare);
+    }
+
+    if (NULL == new_pqueue->heap && NULL == new_pqueue->sorted_list)
     {
         free(new_pqueue);
         new_pqueue = NULL;
         return (NULL);
     }
 
-    new_pqueue->sorted_list = new_list;
-
     return (new_pqueue);
 }
 
 void PQDestroy(pq_t *pqueue)
 {
     assert(NULL != pqueue);
-    assert(NULL != pqueue->sorted_list);
 
-    SortedListDestroy(pqueue->sorted_list);
-    pqueue -> sorted_list = NULL;
+    if (PQ_HEAP == pqueue->backend)
+    {
+        HeapDestroy(pqueue->heap);
+        pqueue->heap = NULL;
+    }
+    else
+    {
+        SortedListDestroy(pqueue->sorted_list);
+        pqueue->sorted_list = NULL;
+    }
 
     free(pqueue);
     pqueue = NULL;
@@ -62,30 +89,25 @@ void PQDestroy(pq_t *pqueue)
 
 int PQEnqueue(pq_t *pqueue, void *data)
 {
-    sorted_list_t *list = NULL;
-    sorted_list_iterator_t result = {0};
-    sorted_list_iterator_t tail = {0};
-
     assert(NULL != pqueue);
-    assert(NULL != pqueue->sorted_list);
     assert(NULL != data);
 
-    list = pqueue->sorted_list;
-    tail = SortedListEnd(list);
-    result = SortedListInsert(list, data);
-
-    if (SortedListIsSameIterator(result, tail))
+    if (PQ_HEAP == pqueue->backend)
     {
-        return (FAILURE);
+        return (HeapPush(pqueue->heap, data));
     }
 
-    return (SUCCESS);
+    return (ListEnqueue(pqueue->sorted_list, data));
 }
 
 void *PQDequeue(pq_t *pqueue)
 {
     assert(NULL != pqueue);
-    assert(NULL != pqueue->sorted_list);
+
+    if (PQ_HEAP == pqueue->backend)
+    {
+        return (HeapPop(pqueue->heap));
+    }
 
     return (SortedListPopBack(pqueue->sorted_list));
 }
@@ -95,7 +117,11 @@ void *PQPeek(const pq_t *pqueue)
     sorted_list_iterator_t highest_node = {0};
 
     assert(NULL != pqueue);
-    assert(NULL != pqueue->sorted_list);
+
+    if (PQ_HEAP == pqueue->backend)
+    {
+        return (HeapPeek(pqueue->heap));
+    }
 
     highest_node = SortedListPrev(SortedListEnd(pqueue->sorted_list));
 
@@ -105,7 +131,11 @@ void *PQPeek(const pq_t *pqueue)
 int PQIsEmpty(const pq_t *pqueue)
 {
     assert(NULL != pqueue);
-    assert(NULL != pqueue->sorted_list);
+
+    if (PQ_HEAP == pqueue->backend)
+    {
+        return (HeapIsEmpty(pqueue->heap));
+    }
 
     return (SortedListIsEmpty(pqueue->sorted_list));
 }
@@ -113,7 +143,11 @@ int PQIsEmpty(const pq_t *pqueue)
 size_t PQSize(const pq_t *pqueue)
 {
     assert(NULL != pqueue);
-    assert(NULL != pqueue->sorted_list);
+
+    if (PQ_HEAP == pqueue->backend)
+    {
+        return (HeapSize(pqueue->heap));
+    }
     
     return (SortedListSize(pqueue->sorted_list)); 
 }
@@ -123,7 +157,12 @@ void PQClear(pq_t *pqueue)
     sorted_list_t *list = NULL;
 
     assert(NULL != pqueue);
-    assert(NULL != pqueue->sorted_list);
+
+    if (PQ_HEAP == pqueue->backend)
+    {
+        HeapClear(pqueue->heap);
+        return;
+    }
 
     list = pqueue->sorted_list;
 
@@ -135,18 +174,62 @@ void PQClear(pq_t *pqueue)
 
 void *PQErase(pq_t *pqueue, pqueue_is_match_func_t is_match, void *param)
 {
-    sorted_list_t *list = NULL;
+    assert(NULL != pqueue);
+    assert(NULL != is_match);
+    assert(NULL != param);
+
+    if (PQ_HEAP == pqueue->backend)
+    {
+        return (HeapRemove(pqueue->heap, is_match, param));
+    }
+
+    return (ListErase(pqueue->sorted_list, is_match, param));
+}
+
+void PQSetPositionFunc(pq_t *pqueue, pqueue_set_position_func_t set_position)
+{
+    assert(NULL != pqueue);
+    assert(PQ_HEAP == pqueue->backend);
+
+    HeapSetIndexFunc(pqueue->heap, set_position);
+}
+
+void *PQEraseAt(pq_t *pqueue, size_t position)
+{
+    assert(NULL != pqueue);
+    assert(PQ_HEAP == pqueue->backend);
+
+    return (HeapRemoveAt(pqueue->heap, position));
+}
+
+static int ListEnqueue(sorted_list_t *list, void *data)
+{
+    sorted_list_iterator_t result = {0};
+    sorted_list_iterator_t tail = {0};
+
+    assert(NULL != list);
+
+    tail = SortedListEnd(list);
+    result = SortedListInsert(list, data);
+
+    if (SortedListIsSameIterator(result, tail))
+    {
+        return (FAILURE);
+    }
+
+    return (SUCCESS);
+}
+
+static void *ListErase(sorted_list_t *list, pqueue_is_match_func_t is_match,
+                                                                void *param)
+{
     sorted_list_iterator_t begin = {0};
     sorted_list_iterator_t tail = {0};
     sorted_list_iterator_t element_to_remove = {0};
     void *removed_element_data = NULL;
 
-    assert(NULL != pqueue);
-    assert(NULL != pqueue->sorted_list);
-    assert(NULL != is_match);
-    assert(NULL != param);
+    assert(NULL != list);
 
-    list = pqueue->sorted_list;
     begin = SortedListBegin(list);
     tail = SortedListEnd(list);
 
@@ -160,4 +243,4 @@ void *PQErase(pq_t *pqueue, pqueue_is_match_func_t is_match, void *param)
     SortedListRemove(element_to_remove);
 
     return (removed_element_data);
-}
\ No newline at end of file
+}
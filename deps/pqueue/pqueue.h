@@ -16,9 +16,20 @@
 #define __NSRD_PQUEUE_H__
 
 #include "sorted_list.h"
+#include "heap.h"
 
 typedef struct pq pq_t;
 
+/*
+DESCRIPTION
+    Storage that keeps the elements of the priority queue.
+    PQ_SORTED_LIST: sorted doubly linked list. Elements with the same priority
+    are dequeued in the order of insertion. Enqueue is O(n).
+    PQ_HEAP: array-backed binary heap. Enqueue and dequeue are O(log n), the
+    order of elements with the same priority is not defined.
+*/
+typedef enum pq_backend {PQ_SORTED_LIST, PQ_HEAP} pq_backend_t;
+
 /*
 DESCRIPTION
     Pointer to the user's function that compares data1 and data2.
@@ -48,6 +59,23 @@ INPUT
 */
 typedef int (*pqueue_is_match_func_t)(const void *data, void *param);
 
+/* position reported for the element that left the priority queue */
+#define PQ_NO_POSITION HEAP_NO_INDEX
+
+/*
+DESCRIPTION
+    Pointer to the user's function that is told the current position of the
+    data in the priority queue every time the data is moved. The position can
+    be stored in the data itself and later passed to PQEraseAt.
+RETURN
+    Doesn't return anything.
+INPUT
+    data: pointer to the user's data.
+    position: new position of the data, PQ_NO_POSITION when it leaves the
+    priority queue.
+*/
+typedef void (*pqueue_set_position_func_t)(void *data, size_t position);
+
 /*
 DESCRIPTION
     Creates new priority queue. Queue will use pattern of sorting, based
@@ -64,6 +92,21 @@ TIME COMPLEXITY:
 */
 pq_t *PQCreate(pqueue_compare_func_t compare);
 
+/*
+DESCRIPTION
+    Same as PQCreate, but the storage of the priority queue is chosen by
+    the backend.
+RETURN
+    Pointer to the created priority queue on success.
+    NULL if allocation failed.
+INPUT
+    compare: pointer to the compare function.
+    backend: storage of the priority queue.
+TIME COMPLEXITY:
+    O(1)
+*/
+pq_t *PQCreateEx(pqueue_compare_func_t compare, pq_backend_t backend);
+
 /*
 DESCRIPTION
     Frees the memory allocated for each element of a priority queue and the
@@ -90,7 +133,7 @@ INPUT
     pqueue: pointer to the priority queue.
     data: pointer to the user's data.
 TIME COMPLEXITY:
-    O(n)
+    O(n) - PQ_SORTED_LIST, O(log n) - PQ_HEAP.
 */
 int PQEnqueue(pq_t *pqueue, void *data);
 
@@ -103,7 +146,7 @@ RETURN
 INPUT
     pqueue: pointer to the priority queue.
 TIME COMPLEXITY:
-    O(1)
+    O(1) - PQ_SORTED_LIST, O(log n) - PQ_HEAP.
 */
 void *PQDequeue(pq_t *pqueue);
 
@@ -136,13 +179,13 @@ int PQIsEmpty(const pq_t *pqueue);
 
 /*
 DESCRIPTION
-    Traverses the sorted linked list and returns the amount of elements.
+    Returns the amount of elements in the priority queue.
 RETURN
     Number of elements in priority queue.
 INPUT
     pqueue: pointer to the priority queue.
 TIME COMPLEXITY:
-    O(n)
+    O(n) - PQ_SORTED_LIST, O(1) - PQ_HEAP.
 */
 size_t PQSize(const pq_t *pqueue);
 
@@ -154,7 +197,7 @@ RETURN
 INPUT
     pqueue: pointer to the priority queue.
 TIME COMPLEXITY:
-    O(n)
+    O(n) - PQ_SORTED_LIST, O(1) - PQ_HEAP.
 */
 void PQClear(pq_t *pqueue);
 
@@ -176,4 +219,32 @@ TIME COMPLEXITY:
 */
 void *PQErase(pq_t *pqueue, pqueue_is_match_func_t is_match, void *param);
 
+/*
+DESCRIPTION
+    Sets the function that tracks the positions of the elements. Supported
+    by the PQ_HEAP backend only. Should be set while the queue is empty.
+RETURN
+    Doesn't return anything.
+INPUT
+    pqueue: pointer to the priority queue.
+    set_position: user's function that receives the positions.
+TIME COMPLEXITY:
+    O(1)
+*/
+void PQSetPositionFunc(pq_t *pqueue, pqueue_set_position_func_t set_position);
+
+/*
+DESCRIPTION
+    Removes the element on the passed position, as reported by the
+    set_position function. Supported by the PQ_HEAP backend only.
+RETURN
+    Pointer to user's data of removed element.
+INPUT
+    pqueue: pointer to the priority queue.
+    position: position of the element.
+TIME COMPLEXITY:
+    O(log n)
+*/
+void *PQEraseAt(pq_t *pqueue, size_t position);
+
 #endif  /* __NSRD_PQUEUE_H__ */ 
\ No newline at end of file
@@ -19,11 +19,14 @@ static int RemoveInt(const void *data, void *param);
 
 
 static void TestPqueue(void);
+static void TestPqueueHeap(void);
+static void TestPqueueBackend(pq_backend_t backend);
 
 int main()
 {
 	TH_TEST_T TESTS[] = {
 		{"Test pqueue", TestPqueue},
+		{"Test pqueue heap", TestPqueueHeap},
 		TH_TESTS_ARRAY_END
 	};
 
@@ -33,10 +36,20 @@ int main()
 }
 
 static void TestPqueue(void)
+{
+	TestPqueueBackend(PQ_SORTED_LIST);
+}
+
+static void TestPqueueHeap(void)
+{
+	TestPqueueBackend(PQ_HEAP);
+}
+
+static void TestPqueueBackend(pq_backend_t backend)
 {
 	int arr[10] = {1,2,3,4,5,6,7,8,9,10};
 
-	pq_t *pqueue = PQCreate(CompareInts);
+	pq_t *pqueue = PQCreateEx(CompareInts, backend);
 
 	PQEnqueue(pqueue, arr);
 	PQEnqueue(pqueue, arr+1);
@@ -3,25 +3,34 @@
 * FILENAME : scheduler.c
 *
 * DESCRIPTION : Scheduler implementation.
-* 
+*
 * AUTHOR : Nick Shenderov
 *
 * DATE : 09.05.2023
-* 
+*
 *******************************************************************************/
 
+#define _POSIX_C_SOURCE 200112L
+
 #include <assert.h> /* assert */
 #include <stdlib.h> /* malloc, free */
-#include <time.h> /* time_t */
-#include <unistd.h> /* sleep */
+#include <errno.h> /* EINTR */
+#include <time.h> /* clock_nanosleep, struct timespec */
 
 #include "scheduler.h"
 #include "task.h"
 #include "pqueue.h"
+#include "timing_wheel.h"
+#include "hash_table.h"
 
 struct scheduler
 {
+    scheduler_backend_t backend;
     pq_t *pq;
+    timing_wheel_t *wheel;
+    hash_table_t *index;
+    struct timespec wheel_start;
+    long tick_ns;
     task_t *curr_running_task;
     int is_running;
     int remove_current_task;
@@ -29,28 +38,94 @@ struct scheduler
 
 enum {FALSE, TRUE};
 
-enum {SUCCESS_OUT, FAIL_OUT};      
+enum {SUCCESS_OUT, FAIL_OUT};
+
+#define MSEC_IN_SEC (1000)
+#define NSEC_IN_MSEC (1000000L)
+#define NSEC_IN_SEC (1000000000L)
+#define DEFAULT_TICK_MS (1)
 
 static scheduler_run_status_t TaskExecutionHandler(scheduler_t *scheduler);
 static void FailureHandler(scheduler_t *scheduler);
 static void CompleteHandler(scheduler_t *scheduler);
 static int RescheduleHandler(scheduler_t *scheduler);
 
-static int WaitUntill(time_t task_time);
+static int QueueAdd(scheduler_t *scheduler, task_t *task);
+static void QueueRemove(scheduler_t *scheduler, task_t *task);
+static task_t *QueueNextTask(scheduler_t *scheduler);
+static task_t *WheelNextTask(scheduler_t *scheduler);
+static void QueueClear(scheduler_t *scheduler);
+static int DestroyQueuedTask(void *task, void *scheduler);
+static void DestroyTask(scheduler_t *scheduler, task_t *task);
+
+static unsigned long TimeToTick(const scheduler_t *scheduler,
+                                const struct timespec *time, int round_up);
+static struct timespec TickToTime(const scheduler_t *scheduler,
+                                  unsigned long tick);
+static size_t HashUID(const void *uid);
+
+static int WaitUntill(const scheduler_t *scheduler,
+                      const struct timespec *task_time);
 
 scheduler_t *SchedulerCreate(void)
 {
-    pq_t *new_pq = NULL;
+    scheduler_options_t options = {0};
 
-    scheduler_t *new_scheduler = (scheduler_t *) malloc(sizeof(scheduler_t));
+    return (SchedulerCreateEx(&options));
+}
+
+scheduler_t *SchedulerCreateEx(const scheduler_options_t *options)
+{
+    scheduler_t *new_scheduler = NULL;
+
+    assert(NULL != options);
+
+    new_scheduler = (scheduler_t *) malloc(sizeof(scheduler_t));
     if (NULL == new_scheduler)
     {
         return (NULL);
     }
 
-    new_pq = PQCreate(TaskCompare);
-    if (NULL == new_pq)
+    new_scheduler->backend = options->backend;
+    new_scheduler->pq = NULL;
+    new_scheduler->wheel = NULL;
+    new_scheduler->tick_ns = (long)(0 == options->tick_ms ? DEFAULT_TICK_MS
+                                        : options->tick_ms) * NSEC_IN_MSEC;
+
+    if (SCHEDULER_TIMING_WHEEL == options->backend)
     {
+        new_scheduler->wheel = TimingWheelCreate();
+    }
+    else
+    {
+        new_scheduler->pq = PQCreateEx(TaskCompare, PQ_HEAP);
+        if (NULL != new_scheduler->pq)
+        {
+            PQSetPositionFunc(new_scheduler->pq, TaskSetPosition);
+        }
+    }
+
+    new_scheduler->index = HashTableCreate(HashUID, TaskIsSame, 0);
+
+    if ((NULL == new_scheduler->pq && NULL == new_scheduler->wheel)
+     || NULL == new_scheduler->index
+     || 0 != clock_gettime(CLOCK_MONOTONIC, &new_scheduler->wheel_start))
+    {
+        if (NULL != new_scheduler->index)
+        {
+            HashTableDestroy(new_scheduler->index);
+        }
+
+        if (NULL != new_scheduler->pq)
+        {
+            PQDestroy(new_scheduler->pq);
+        }
+
+        if (NULL != new_scheduler->wheel)
+        {
+            TimingWheelDestroy(new_scheduler->wheel);
+        }
+
         free(new_scheduler);
         new_scheduler = NULL;
 
@@ -60,7 +135,6 @@ scheduler_t *SchedulerCreate(void)
     new_scheduler->is_running = FALSE;
     new_scheduler->remove_current_task = FALSE;
     new_scheduler->curr_running_task = NULL;
-    new_scheduler->pq = new_pq;
 
     return (new_scheduler);
 }
@@ -71,20 +145,42 @@ void SchedulerDestroy(scheduler_t *scheduler)
 
     SchedulerClear(scheduler);
 
-    PQDestroy(scheduler->pq);
-    scheduler->pq = NULL;
+    if (SCHEDULER_TIMING_WHEEL == scheduler->backend)
+    {
+        TimingWheelDestroy(scheduler->wheel);
+        scheduler->wheel = NULL;
+    }
+    else
+    {
+        PQDestroy(scheduler->pq);
+        scheduler->pq = NULL;
+    }
+
+    HashTableDestroy(scheduler->index);
+    scheduler->index = NULL;
 
     free(scheduler);
     scheduler = NULL;
 }
 
-nsrd_uid_t SchedulerAddTask(scheduler_t *scheduler, 
-                            int (*action)(void *params), 
-                            void (*cleanup)(void *params), 
+nsrd_uid_t SchedulerAddTask(scheduler_t *scheduler,
+                            int (*action)(void *params),
+                            void (*cleanup)(void *params),
                             void *action_params, void *cleanup_params,
                             size_t interval_seconds)
+{
+    return (SchedulerAddTaskMs(scheduler, action, cleanup, action_params,
+                               cleanup_params, interval_seconds * MSEC_IN_SEC));
+}
+
+nsrd_uid_t SchedulerAddTaskMs(scheduler_t *scheduler,
+                              int (*action)(void *params),
+                              void (*cleanup)(void *params),
+                              void *action_params, void *cleanup_params,
+                              size_t interval_ms)
 {
     task_t *new_task = NULL;
+    nsrd_uid_t uid = BadUID;
 
     task_action_t t_action = NULL;
     task_clean_func_t t_cleanup = NULL;
@@ -94,17 +190,19 @@ nsrd_uid_t SchedulerAddTask(scheduler_t *scheduler,
     assert(NULL != cleanup);
 
     t_action = (task_action_t)action;
-    t_cleanup = (task_clean_func_t)cleanup; 
+    t_cleanup = (task_clean_func_t)cleanup;
 
 
-    new_task = TaskCreate(t_action, t_cleanup, action_params, cleanup_params,
-                                                        interval_seconds);
+    new_task = TaskCreateMs(t_action, t_cleanup, action_params, cleanup_params,
+                                                                interval_ms);
     if(NULL == new_task)
     {
         return (BadUID);
     }
 
-    if(FAIL_OUT == PQEnqueue(scheduler->pq, new_task))
+    uid = TaskGetUID(new_task);
+
+    if(FAIL_OUT == HashTableInsert(scheduler->index, &uid, new_task))
     {
         TaskDestroy(new_task);
         new_task = NULL;
@@ -112,7 +210,15 @@ nsrd_uid_t SchedulerAddTask(scheduler_t *scheduler,
         return (BadUID);
     }
 
-    return (TaskGetUID(new_task));
+    if(FAIL_OUT == QueueAdd(scheduler, new_task))
+    {
+        DestroyTask(scheduler, new_task);
+        new_task = NULL;
+
+        return (BadUID);
+    }
+
+    return (uid);
 }
 
 int SchedulerRemoveTask(scheduler_t *scheduler, nsrd_uid_t uid)
@@ -121,18 +227,20 @@ int SchedulerRemoveTask(scheduler_t *scheduler, nsrd_uid_t uid)
 
     assert(NULL != scheduler);
 
-    if (NULL != scheduler->curr_running_task && TaskIsSame(scheduler->curr_running_task, &uid))
+    task = HashTableFind(scheduler->index, &uid);
+    if(NULL == task)
     {
-        scheduler->remove_current_task = TRUE;
         return (FAIL_OUT);
     }
 
-    task = PQErase(scheduler->pq,(pqueue_is_match_func_t) TaskIsSame, &uid);
-    if(NULL == task)
+    if (task == scheduler->curr_running_task)
     {
+        scheduler->remove_current_task = TRUE;
         return (FAIL_OUT);
     }
-    TaskDestroy(task);
+
+    QueueRemove(scheduler, task);
+    DestroyTask(scheduler, task);
     task = NULL;
 
     return (SUCCESS_OUT);
@@ -149,16 +257,18 @@ int SchedulerRun(scheduler_t *scheduler)
 
     while(!SchedulerIsEmpty(scheduler) && TRUE == scheduler->is_running)
     {
-        task_t *task = PQDequeue(scheduler->pq);
-        scheduler->curr_running_task = task;
-
-        if(SUCCESS_OUT != WaitUntill(TaskGetExecutionTime(task)))
+        task_t *task = QueueNextTask(scheduler);
+        if(NULL == task)
         {
-            FailureHandler(scheduler);
-            exit_status = FAILURE;
+            if(TRUE == scheduler->is_running)
+            {
+                SchedulerStop(scheduler);
+                exit_status = FAILURE;
+            }
             break;
         }
 
+        scheduler->curr_running_task = task;
 
         exit_status = TaskExecutionHandler(scheduler);
         if(FALSE == scheduler->is_running && exit_status == SUCCESS)
@@ -167,6 +277,11 @@ int SchedulerRun(scheduler_t *scheduler)
         }
     }
 
+    if(FALSE == scheduler->is_running && exit_status == SUCCESS)
+    {
+        exit_status = STOPPED;
+    }
+
     return (exit_status);
 }
 
@@ -181,6 +296,11 @@ size_t SchedulerSize(const scheduler_t *scheduler)
 {
     assert(NULL != scheduler);
 
+    if (SCHEDULER_TIMING_WHEEL == scheduler->backend)
+    {
+        return (TimingWheelSize(scheduler->wheel));
+    }
+
     return (PQSize(scheduler->pq));
 }
 
@@ -188,44 +308,235 @@ int SchedulerIsEmpty(const scheduler_t *scheduler)
 {
     assert(NULL != scheduler);
 
+    if (SCHEDULER_TIMING_WHEEL == scheduler->backend)
+    {
+        return (TimingWheelIsEmpty(scheduler->wheel));
+    }
+
     return (PQIsEmpty(scheduler->pq));
 }
 
 void SchedulerClear(scheduler_t *scheduler)
 {
-    pq_t *pq = NULL;
-
     assert(NULL != scheduler);
 
-    pq = scheduler->pq;
-
     if(NULL != scheduler->curr_running_task)
     {
         scheduler->remove_current_task = TRUE;
     }
 
-    while(!PQIsEmpty(pq))
+    QueueClear(scheduler);
+}
+
+static int QueueAdd(scheduler_t *scheduler, task_t *task)
+{
+    struct timespec task_time = {0};
+    tw_timer_t timer = NULL;
+
+    assert(NULL != scheduler);
+    assert(NULL != task);
+
+    if (SCHEDULER_TIMING_WHEEL != scheduler->backend)
+    {
+        return (PQEnqueue(scheduler->pq, task));
+    }
+
+    task_time = TaskGetExecutionTime(task);
+
+    timer = TimingWheelAdd(scheduler->wheel, task,
+                           TimeToTick(scheduler, &task_time, TRUE));
+    if (NULL == timer)
     {
-        task_t *current_task = (task_t *)PQDequeue(pq);
-        TaskDestroy(current_task);
+        return (FAIL_OUT);
     }
+
+    TaskSetHandle(task, timer);
+
+    return (SUCCESS_OUT);
 }
 
-static int WaitUntill(time_t task_time)
+static void QueueRemove(scheduler_t *scheduler, task_t *task)
 {
-    time_t curr_time = 0;
-    double sleep_time = 0.0;
+    assert(NULL != scheduler);
+    assert(NULL != task);
 
-    if (-1 == time(&curr_time))
+    if (SCHEDULER_TIMING_WHEEL == scheduler->backend)
     {
-        return (FAIL_OUT);
-    }   
+        TimingWheelRemove(scheduler->wheel, (tw_timer_t)TaskGetHandle(task));
+        TaskSetHandle(task, NULL);
+    }
+    else
+    {
+        PQEraseAt(scheduler->pq, TaskGetPosition(task));
+    }
+}
 
-    sleep_time = difftime(task_time, curr_time);
+static task_t *QueueNextTask(scheduler_t *scheduler)
+{
+    task_t *task = NULL;
+    struct timespec task_time = {0};
+
+    assert(NULL != scheduler);
 
-    if (0.0 < sleep_time)
+    if (SCHEDULER_TIMING_WHEEL == scheduler->backend)
     {
-        sleep(sleep_time);
+        return (WheelNextTask(scheduler));
+    }
+
+    task = PQDequeue(scheduler->pq);
+    task_time = TaskGetExecutionTime(task);
+
+    if(SUCCESS_OUT != WaitUntill(scheduler, &task_time))
+    {
+        scheduler->curr_running_task = task;
+        FailureHandler(scheduler);
+
+        return (NULL);
+    }
+
+    return (task);
+}
+
+static task_t *WheelNextTask(scheduler_t *scheduler)
+{
+    timing_wheel_t *wheel = NULL;
+    task_t *task = NULL;
+
+    assert(NULL != scheduler);
+
+    wheel = scheduler->wheel;
+
+    while (NULL == (task = TimingWheelPopExpired(wheel)))
+    {
+        struct timespec now = {0};
+        struct timespec next_time = {0};
+
+        if (TimingWheelIsEmpty(wheel) || FALSE == scheduler->is_running)
+        {
+            return (NULL);
+        }
+
+        next_time = TickToTime(scheduler, TimingWheelNextTick(wheel));
+
+        if (SUCCESS_OUT != WaitUntill(scheduler, &next_time)
+         || 0 != clock_gettime(CLOCK_MONOTONIC, &now))
+        {
+            return (NULL);
+        }
+
+        TimingWheelAdvance(wheel, TimeToTick(scheduler, &now, FALSE));
+    }
+
+    TaskSetHandle(task, NULL);
+
+    return (task);
+}
+
+static void QueueClear(scheduler_t *scheduler)
+{
+    assert(NULL != scheduler);
+
+    if (SCHEDULER_TIMING_WHEEL == scheduler->backend)
+    {
+        TimingWheelForEach(scheduler->wheel, DestroyQueuedTask, scheduler);
+        TimingWheelClear(scheduler->wheel);
+
+        return;
+    }
+
+    while(!PQIsEmpty(scheduler->pq))
+    {
+        DestroyTask(scheduler, (task_t *)PQDequeue(scheduler->pq));
+    }
+}
+
+static int DestroyQueuedTask(void *task, void *scheduler)
+{
+    DestroyTask((scheduler_t *)scheduler, (task_t *)task);
+
+    return (SUCCESS_OUT);
+}
+
+static void DestroyTask(scheduler_t *scheduler, task_t *task)
+{
+    nsrd_uid_t uid = BadUID;
+
+    assert(NULL != scheduler);
+    assert(NULL != task);
+
+    uid = TaskGetUID(task);
+    HashTableRemove(scheduler->index, &uid);
+
+    TaskDestroy(task);
+}
+
+static unsigned long TimeToTick(const scheduler_t *scheduler,
+                                const struct timespec *time, int round_up)
+{
+    long elapsed_ns = 0;
+
+    elapsed_ns = (time->tv_sec - scheduler->wheel_start.tv_sec) * NSEC_IN_SEC
+               + (time->tv_nsec - scheduler->wheel_start.tv_nsec);
+
+    if (0 >= elapsed_ns)
+    {
+        return (0);
+    }
+
+    if (round_up)
+    {
+        elapsed_ns += scheduler->tick_ns - 1;
+    }
+
+    return ((unsigned long)(elapsed_ns / scheduler->tick_ns));
+}
+
+static struct timespec TickToTime(const scheduler_t *scheduler,
+                                  unsigned long tick)
+{
+    struct timespec time = scheduler->wheel_start;
+    unsigned long offset_ns = tick * (unsigned long)scheduler->tick_ns;
+
+    /* like TimeToTick the offset is kept in nanoseconds, so any tick works,
+       also one that does not divide a second */
+    time.tv_sec += (time_t)(offset_ns / NSEC_IN_SEC);
+    time.tv_nsec += (long)(offset_ns % NSEC_IN_SEC);
+
+    if (NSEC_IN_SEC <= time.tv_nsec)
+    {
+        time.tv_nsec -= NSEC_IN_SEC;
+        ++time.tv_sec;
+    }
+
+    return (time);
+}
+
+static size_t HashUID(const void *uid)
+{
+    const nsrd_uid_t *conv_uid = (const nsrd_uid_t *)uid;
+
+    return (conv_uid->counter ^ ((size_t)conv_uid->pid << 20)
+                              ^ (size_t)conv_uid->timestamp);
+}
+
+static int WaitUntill(const scheduler_t *scheduler,
+                      const struct timespec *task_time)
+{
+    int status = 0;
+
+    assert(NULL != scheduler);
+    assert(NULL != task_time);
+
+    do
+    {
+        status = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, task_time,
+                                                                        NULL);
+    }
+    while (EINTR == status && TRUE == scheduler->is_running);
+
+    if (SUCCESS_OUT != status && EINTR != status)
+    {
+        return (FAIL_OUT);
     }
 
     return (SUCCESS_OUT);
@@ -265,7 +576,7 @@ static void FailureHandler(scheduler_t *scheduler)
 {
     assert(NULL != scheduler);
 
-    TaskDestroy(scheduler->curr_running_task);
+    DestroyTask(scheduler, scheduler->curr_running_task);
     scheduler->curr_running_task = NULL;
     SchedulerStop(scheduler);
 }
@@ -275,7 +586,7 @@ static void CompleteHandler(scheduler_t *scheduler)
     assert(NULL != scheduler);
 
     scheduler->remove_current_task = FALSE;
-    TaskDestroy(scheduler->curr_running_task);
+    DestroyTask(scheduler, scheduler->curr_running_task);
     scheduler->curr_running_task = NULL;
 }
 
@@ -292,7 +603,7 @@ static int RescheduleHandler(scheduler_t *scheduler)
         return(FAIL_OUT);
     }
 
-    if(SUCCESS_OUT != PQEnqueue(scheduler->pq, task))
+    if(SUCCESS_OUT != QueueAdd(scheduler, task))
     {
         return (FAIL_OUT);
     }
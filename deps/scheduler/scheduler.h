@@ -30,6 +30,35 @@ FAILURE,
 STOPPED
 } scheduler_run_status_t;
 
+/*
+DESCRIPTION
+    Storage that keeps the tasks waiting for execution.
+    SCHEDULER_PQUEUE: priority queue on a binary heap. Tasks are executed
+    with the precision of the clock. Adding and removing a task is O(log n).
+    SCHEDULER_TIMING_WHEEL: hierarchical timing wheel. Execution times are
+    rounded up to the tick of the wheel. Adding and removing a task is O(1).
+*/
+typedef enum scheduler_backend
+{
+SCHEDULER_PQUEUE,
+SCHEDULER_TIMING_WHEEL
+} scheduler_backend_t;
+
+/*
+DESCRIPTION
+    Options of the scheduler passed to SchedulerCreateEx. Fields that are
+    left zero get their default values.
+FIELDS
+    backend: storage of the tasks. Default: SCHEDULER_PQUEUE.
+    tick_ms: length of the tick of SCHEDULER_TIMING_WHEEL in milliseconds.
+    Default: 1.
+*/
+typedef struct scheduler_options
+{
+    scheduler_backend_t backend;
+    size_t tick_ms;
+} scheduler_options_t;
+
 /*
 DESCRIPTION
     Creates new scheduler. It will sort and execute tasks, based on time.
@@ -45,6 +74,19 @@ TIME COMPLEXITY
 */
 scheduler_t *SchedulerCreate(void);
 
+/*
+DESCRIPTION
+    Same as SchedulerCreate, but the scheduler is configured by the options.
+RETURN
+    Pointer to the created scheduler on success.
+    NULL if allocation failed.
+INPUT
+    options: pointer to the options of the scheduler.
+TIME COMPLEXITY
+	O(1)
+*/
+scheduler_t *SchedulerCreateEx(const scheduler_options_t *options);
+
 /*
 DESCRIPTION
     Frees the memory allocated for each task of scheduler and
@@ -77,7 +119,7 @@ INPUT
     interval_seconds: how many seconds before execute(s) after creating task.
         Also reschedule action() task if needed.
 TIME COMPLEXITY
-	O(n)
+	O(log n) - SCHEDULER_PQUEUE, O(1) - SCHEDULER_TIMING_WHEEL.
 */
 nsrd_uid_t SchedulerAddTask(scheduler_t *scheduler, 
                             int (*action)(void *params), 
@@ -85,6 +127,29 @@ nsrd_uid_t SchedulerAddTask(scheduler_t *scheduler,
                             void *action_params, void *cleanup_params,
                             size_t interval_seconds);
 
+/*
+DESCRIPTION
+    Same as SchedulerAddTask, but the interval is passed in milliseconds.
+RETURN
+    Task's unique identifier nsrd_uid_t if success.
+    BadUID if fail.
+INPUT
+    scheduler: pointer to the scheduler.
+    action: pointer to user's action function.
+    cleanup: pointer to user's cleanup function.
+    action_params: pointer to users params for action.
+    cleanup_params: pointer to users params for cleanup.
+    interval_ms: how many milliseconds before execute(s) after creating task.
+        Also reschedule action() task if needed.
+TIME COMPLEXITY
+	O(log n) - SCHEDULER_PQUEUE, O(1) - SCHEDULER_TIMING_WHEEL.
+*/
+nsrd_uid_t SchedulerAddTaskMs(scheduler_t *scheduler, 
+                              int (*action)(void *params), 
+                              void (*cleanup)(void *params), 
+                              void *action_params, void *cleanup_params,
+                              size_t interval_ms);
+
 /*
 DESCRIPTION
     Removes the task, represented by uid from a scheduler, from the scheduler.
@@ -98,7 +163,7 @@ INPUT
     scheduler: pointer to the scheduler.
     uid - unique identifier representing task to remove.
 TIME COMPLEXITY
-	O(n)
+	O(log n) - SCHEDULER_PQUEUE, O(1) - SCHEDULER_TIMING_WHEEL.
 */
 int SchedulerRemoveTask(scheduler_t *scheduler, nsrd_uid_t uid);
 
@@ -137,13 +202,13 @@ void SchedulerStop(scheduler_t *scheduler);
 
 /*
 DESCRIPTION
-    Traverses the scheduler and returns the amount of tasks.
+    Returns the amount of tasks in the scheduler.
 RETURN
     Number of tasks in scheduler.
 INPUT
     scheduler: pointer to the scheduler.
 TIME COMPLEXITY
-	O(n)
+	O(1)
 */
 size_t SchedulerSize(const scheduler_t *scheduler);
 /*
@@ -10,9 +10,12 @@
 * 
 *******************************************************************************/
 
+#define _POSIX_C_SOURCE 200112L
+
 #include <stdlib.h> /* free */
 #include <stdio.h> /* printf */
 #include <string.h> /* strstr, fclose, fopen, fread, feof */
+#include <time.h> /* clock_gettime */
 
 #include "scheduler.h"
 #include "testing.h"
@@ -21,6 +24,9 @@
 enum {COMPLETE, RESCHEDULE, FAILED};
 
 #define DUMMY_TASK scheduler, Execute, Cleanup, NULL, NULL, 2
+#define RESCHEDULE_ITERATIONS (200)
+#define MSEC_IN_SEC (1000)
+#define NSEC_IN_MSEC (1000000L)
 
 typedef int(*action_func_t)(void *params);
 typedef int(*exit_func_t)(void *params);
@@ -35,6 +41,27 @@ typedef struct op_params
 	int repetable;
 } op_params_container_t;
 
+typedef struct record_params
+{
+	scheduler_t *scheduler;
+	int **next;
+	int id;
+} record_params_t;
+
+typedef struct count_params
+{
+	scheduler_t *scheduler;
+	size_t iterations;
+	size_t allocations_at_start;
+	size_t allocations_at_end;
+} count_params_t;
+
+/* glibc allocator, used to count the allocations made by the scheduler */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static size_t g_allocations = 0;
+
 static int Execute(void *operation_params);
 static int ExitByFile(void *operation_params);
 static int ExitByValue(void *operation_params);
@@ -51,6 +78,13 @@ static void TestSchedulerClear(void);
 static void TestSchedulerRun(void);
 static void TestSchedulerStop(void);
 static void TestSchedulerExitByFile(void);
+static void TestSchedulerTimingWheel(void);
+static int RecordOrder(void *operation_params);
+static void TestSchedulerTicks(void);
+static void CheckTick(size_t tick_ms, size_t delay_ms);
+static void TestSchedulerNoAllocations(void);
+static void CountAllocations(scheduler_backend_t backend);
+static int CountedReschedule(void *operation_params);
 
 int main()
 {
@@ -64,6 +98,9 @@ int main()
 		{"SchedulerRun", TestSchedulerRun},
 		{"SchedulerStop", TestSchedulerStop},
 		{"ExitByFile", TestSchedulerExitByFile},
+		{"TimingWheel", TestSchedulerTimingWheel},
+		{"Ticks", TestSchedulerTicks},
+		{"NoAllocations", TestSchedulerNoAllocations},
 		TH_TESTS_ARRAY_END
 	};
 
@@ -336,6 +373,175 @@ static void TestSchedulerExitByFile(void)
 	(void) uid2;
 }
 
+static void TestSchedulerTimingWheel(void)
+{
+	int order[3] = {0};
+	int *next = order;
+	record_params_t params[3] = {{NULL, NULL, 1}, {NULL, NULL, 2},
+	                             {NULL, NULL, 3}};
+	nsrd_uid_t uid = {0};
+	size_t i = 0;
+
+	scheduler_options_t options = {SCHEDULER_TIMING_WHEEL, 1};
+	scheduler_t *scheduler = SchedulerCreateEx(&options);
+
+	TH_ASSERT(NULL != scheduler);
+
+	for (i = 0; i < 3; ++i)
+	{
+		params[i].scheduler = scheduler;
+		params[i].next = &next;
+	}
+
+	SchedulerAddTaskMs(scheduler, RecordOrder, Cleanup, params, NULL, 30);
+	SchedulerAddTaskMs(scheduler, RecordOrder, Cleanup, params + 1, NULL, 10);
+	uid = SchedulerAddTaskMs(scheduler, RecordOrder, Cleanup, params + 2,
+	                                                              NULL, 20);
+	SchedulerAddTaskMs(scheduler, RecordOrder, Cleanup, params + 2, NULL, 5000);
+
+	TH_ASSERT(4 == SchedulerSize(scheduler));
+	TH_ASSERT(0 == SchedulerRemoveTask(scheduler, uid));
+	TH_ASSERT(0 != SchedulerRemoveTask(scheduler, uid));
+	TH_ASSERT(3 == SchedulerSize(scheduler));
+
+	SchedulerAddTaskMs(scheduler, RecordOrder, Cleanup, params + 2, NULL, 20);
+
+	TH_ASSERT(STOPPED == SchedulerRun(scheduler));
+
+	TH_ASSERT(2 == order[0]);
+	TH_ASSERT(3 == order[1]);
+	TH_ASSERT(1 == order[2]);
+	TH_ASSERT(1 == SchedulerSize(scheduler));
+
+	SchedulerClear(scheduler);
+	TH_ASSERT(1 == SchedulerIsEmpty(scheduler));
+
+	SchedulerDestroy(scheduler);
+}
+
+static int RecordOrder(void *operation_params)
+{
+	record_params_t *params = operation_params;
+
+	**params->next = params->id;
+	++*params->next;
+
+	if (1 == params->id)
+	{
+		SchedulerStop(params->scheduler);
+	}
+
+	return (COMPLETE);
+}
+
+/* ticks longer than a second and ticks that do not divide it */
+static void TestSchedulerTicks(void)
+{
+	CheckTick(7, 1050);
+	CheckTick(1500, 10);
+}
+
+static void CheckTick(size_t tick_ms, size_t delay_ms)
+{
+	int order[1] = {0};
+	int *next = order;
+	record_params_t params = {NULL, NULL, 1};
+	scheduler_options_t options = {SCHEDULER_TIMING_WHEEL, 0};
+	scheduler_t *scheduler = NULL;
+	struct timespec start = {0};
+	struct timespec end = {0};
+	long elapsed_ms = 0;
+
+	options.tick_ms = tick_ms;
+	scheduler = SchedulerCreateEx(&options);
+
+	TH_ASSERT(NULL != scheduler);
+
+	params.scheduler = scheduler;
+	params.next = &next;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	SchedulerAddTaskMs(scheduler, RecordOrder, Cleanup, &params, NULL,
+	                                                              delay_ms);
+
+	TH_ASSERT(STOPPED == SchedulerRun(scheduler));
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	elapsed_ms = (end.tv_sec - start.tv_sec) * MSEC_IN_SEC
+	           + (end.tv_nsec - start.tv_nsec) / NSEC_IN_MSEC;
+
+	TH_ASSERT(1 == order[0]);
+	TH_ASSERT((long)delay_ms <= elapsed_ms);
+	TH_ASSERT(elapsed_ms <= (long)(delay_ms + tick_ms) + 50);
+
+	SchedulerDestroy(scheduler);
+}
+
+static void TestSchedulerNoAllocations(void)
+{
+	CountAllocations(SCHEDULER_PQUEUE);
+	CountAllocations(SCHEDULER_TIMING_WHEEL);
+}
+
+static void CountAllocations(scheduler_backend_t backend)
+{
+	count_params_t params = {NULL, 0, 0, 0};
+	scheduler_options_t options = {0};
+	scheduler_t *scheduler = NULL;
+
+	options.backend = backend;
+	scheduler = SchedulerCreateEx(&options);
+	params.scheduler = scheduler;
+
+	SchedulerAddTaskMs(scheduler, CountedReschedule, Cleanup, &params, NULL,
+	                                                                      0);
+	SchedulerAddTaskMs(scheduler, Execute, Cleanup, NULL, NULL, 100000);
+
+	TH_ASSERT(STOPPED == SchedulerRun(scheduler));
+	TH_ASSERT(RESCHEDULE_ITERATIONS == params.iterations);
+	TH_ASSERT(params.allocations_at_start == params.allocations_at_end);
+
+	SchedulerDestroy(scheduler);
+}
+
+static int CountedReschedule(void *operation_params)
+{
+	count_params_t *params = operation_params;
+
+	++params->iterations;
+
+	if (1 == params->iterations)
+	{
+		params->allocations_at_start = g_allocations;
+	}
+
+	if (RESCHEDULE_ITERATIONS == params->iterations)
+	{
+		params->allocations_at_end = g_allocations;
+		SchedulerStop(params->scheduler);
+
+		return (COMPLETE);
+	}
+
+	return (RESCHEDULE);
+}
+
+void *malloc(size_t size)
+{
+	++g_allocations;
+
+	return (__libc_malloc(size));
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	++g_allocations;
+
+	return (__libc_realloc(ptr, size));
+}
+
 static int Execute(void *operation_params)
 {
 	op_params_container_t *box = operation_params;
@@ -10,11 +10,17 @@
 * 
 *******************************************************************************/
 
+#define _POSIX_C_SOURCE 200112L
+
 #include <assert.h> /* assert */
 #include <stdlib.h> /* malloc, free, size_t, NULL */
 
 #include "task.h"
 
+#define NSEC_IN_SEC (1000000000L)
+#define NSEC_IN_MSEC (1000000L)
+#define MSEC_IN_SEC (1000)
+
 struct task
 {
     nsrd_uid_t task_id;
@@ -22,12 +28,23 @@ struct task
     task_clean_func_t clean_func;
     void *operation_params;
     void *cleanup_params;   
-    time_t execution_time; 
-    size_t interval_seconds;   
+    struct timespec execution_time; 
+    struct timespec interval;   
+    void *handle;
+    size_t position;
 };
 
+static int SetExecTimeFromNow(task_t *task);
+
 task_t *TaskCreate(task_action_t action, task_clean_func_t clean_up, 
                 void *params, void *cleanup_params, size_t interval_seconds)
+{
+    return (TaskCreateMs(action, clean_up, params, cleanup_params,
+                                            interval_seconds * MSEC_IN_SEC));
+}
+
+task_t *TaskCreateMs(task_action_t action, task_clean_func_t clean_up, 
+                void *params, void *cleanup_params, size_t interval_ms)
 {
     task_t *new_task = NULL;
     nsrd_uid_t uid;
@@ -53,9 +70,20 @@ task_t *TaskCreate(task_action_t action, task_clean_func_t clean_up,
     new_task->clean_func = clean_up;
     new_task->operation_params = params;
     new_task->cleanup_params = cleanup_params;
+    new_task->handle = NULL;
+    new_task->position = TASK_NO_POSITION;
 
-    new_task->execution_time = uid.timestamp + interval_seconds;
-    new_task->interval_seconds = interval_seconds;
+    new_task->interval.tv_sec = (time_t)(interval_ms / MSEC_IN_SEC);
+    new_task->interval.tv_nsec = (long)(interval_ms % MSEC_IN_SEC)
+                                                                * NSEC_IN_MSEC;
+
+    if (0 != SetExecTimeFromNow(new_task))
+    {
+        free(new_task);
+        new_task = NULL;
+
+        return (NULL);
+    }
     
     return (new_task);   
 }                
@@ -85,22 +113,23 @@ op_status_t TaskExecute(task_t *task)
 
 int TaskCompare(const void *task1, const void *task2)
 {
-    double time_difference = 0.0;
     int result = 0;
-    task_t *task1_conv = (task_t *)task1;
-    task_t *task2_conv = (task_t *)task2;
+    const struct timespec *time1 = NULL;
+    const struct timespec *time2 = NULL;
     
     assert(NULL != task1);
     assert(NULL != task2);
     
-    time_difference = difftime(task1_conv->execution_time, 
-                                            task2_conv->execution_time);
+    time1 = &((const task_t *)task1)->execution_time;
+    time2 = &((const task_t *)task2)->execution_time;
     
-    if (0 > time_difference)
+    if (time1->tv_sec < time2->tv_sec
+    || (time1->tv_sec == time2->tv_sec && time1->tv_nsec < time2->tv_nsec))
     {
         result = 1;
     }
-    else if (0 < time_difference)
+    else if (time1->tv_sec > time2->tv_sec
+         || (time1->tv_sec == time2->tv_sec && time1->tv_nsec > time2->tv_nsec))
     {
         result = -1;
     }
@@ -126,7 +155,7 @@ nsrd_uid_t TaskGetUID(const task_t *task)
     return (task->task_id);
 }
 
-time_t TaskGetExecutionTime(const task_t *task)
+struct timespec TaskGetExecutionTime(const task_t *task)
 {
     assert(NULL != task);
     
@@ -135,17 +164,60 @@ time_t TaskGetExecutionTime(const task_t *task)
 
 int TaskUpdateExecTime(task_t *task)
 {
-	time_t current_time = 0;
-	
     assert(NULL != task);
     
-    current_time = time(NULL);
-    if (-1 == current_time)
+    return (SetExecTimeFromNow(task));
+}
+
+void TaskSetHandle(task_t *task, void *handle)
+{
+    assert(NULL != task);
+
+    task->handle = handle;
+}
+
+void *TaskGetHandle(const task_t *task)
+{
+    assert(NULL != task);
+
+    return (task->handle);
+}
+
+void TaskSetPosition(void *task, size_t position)
+{
+    assert(NULL != task);
+
+    ((task_t *)task)->position = position;
+}
+
+size_t TaskGetPosition(const task_t *task)
+{
+    assert(NULL != task);
+
+    return (task->position);
+}
+
+static int SetExecTimeFromNow(task_t *task)
+{
+    struct timespec current_time = {0};
+
+    assert(NULL != task);
+
+    if (0 != clock_gettime(CLOCK_MONOTONIC, &current_time))
     {
-    	return (1);
+        return (1);
     }
-    
-    task->execution_time = current_time + task->interval_seconds;
-    
+
+    current_time.tv_sec += task->interval.tv_sec;
+    current_time.tv_nsec += task->interval.tv_nsec;
+
+    if (NSEC_IN_SEC <= current_time.tv_nsec)
+    {
+        current_time.tv_nsec -= NSEC_IN_SEC;
+        ++current_time.tv_sec;
+    }
+
+    task->execution_time = current_time;
+
     return (0);
 }
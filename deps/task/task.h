@@ -17,12 +17,16 @@
 #ifndef __NSRD_TASK_H__
 #define __NSRD_TASK_H__
 
-#include <time.h> /* time_t */
+#include <stddef.h> /* size_t */
+#include <time.h> /* struct timespec */
 
 #include "uid.h"
 
 typedef struct task task_t;
 
+/* position of a task that is not kept in an array based container */
+#define TASK_NO_POSITION ((size_t)-1)
+
 typedef enum op_status {COMPLETE, RESCHEDULE, FAILED} op_status_t;
 
 /*
@@ -56,7 +60,8 @@ DESCRIPTION
 	Creates new task. Creation may fail, due to memory allocation fail.
 	User is responsible for deallocating tasks using TaskDestroy. 
 	The parameter "execution_time" of the task will be calculated as a sum of
-	the time of creation and passed interval.
+	the time of creation and passed interval. The time is taken from the
+	CLOCK_MONOTONIC clock, so it isn't affected by the wall clock changes.
 RETURN
 	pointer to the task - if success;
 	NULL - if failure.
@@ -70,6 +75,23 @@ INPUT
 task_t *TaskCreate(task_action_t action, task_clean_func_t clean_up, 
 				void *params, void *cleanup_params,  size_t interval_seconds);
 
+/* 
+DESCRIPTION
+	Same as TaskCreate, but the interval of rescheduling is passed in
+	milliseconds.
+RETURN
+	pointer to the task - if success;
+	NULL - if failure.
+INPUT
+	action: pointer to the operation constituting in the task;
+	clean_up: pointer to the function that cleanups after the operation.
+	params: pointer to users params for action.
+	cleanup_params: pointer to users params for clean_up.
+	interval_ms: interval of rescheduling the task in milliseconds.
+*/  
+task_t *TaskCreateMs(task_action_t action, task_clean_func_t clean_up, 
+				void *params, void *cleanup_params,  size_t interval_ms);
+
 /* 
 DESCRIPTION
 	Destroys the task by deallocating memory and running the cleanup function
@@ -134,16 +156,17 @@ nsrd_uid_t TaskGetUID(const task_t *task);
 DESCRIPTION
 	Returns the scheduled execution time of a task.
 RETURN
-	Execution time in seconds since UNIX Epoch.
+	Execution time as an absolute CLOCK_MONOTONIC time point with nanosecond
+	resolution.
 INPUT
 	task: pointer to the task.
 */
-time_t TaskGetExecutionTime(const task_t *task);
+struct timespec TaskGetExecutionTime(const task_t *task);
 
 /* 
 DESCRIPTION
-	Changes the execution time of a task by the interval in seconds,
-	stored in the task.
+	Changes the execution time of a task to the current CLOCK_MONOTONIC time
+	plus the interval stored in the task.
 RETURN
 	0: success.
 	1: fail.
@@ -152,5 +175,49 @@ INPUT
 */
 int TaskUpdateExecTime(task_t *task);
 
+/* 
+DESCRIPTION
+	Stores the handle of the task's position inside the container that keeps
+	the task, so the container can find the task without a search.
+RETURN
+	There is no return for this function.
+INPUT
+	task: pointer to the task.
+	handle: handle of the position. NULL if the task is not in a container.
+*/
+void TaskSetHandle(task_t *task, void *handle);
+
+/* 
+DESCRIPTION
+	Returns the handle of the task's position stored by TaskSetHandle.
+RETURN
+	Handle of the position, NULL if it wasn't set.
+INPUT
+	task: pointer to the task.
+*/
+void *TaskGetHandle(const task_t *task);
+
+/* 
+DESCRIPTION
+	Stores the index of the task inside the array based container that keeps
+	the task. Takes void pointer so it can be passed to the container as is.
+RETURN
+	There is no return for this function.
+INPUT
+	task: pointer to the task.
+	position: index of the task, TASK_NO_POSITION if it is not in a container.
+*/
+void TaskSetPosition(void *task, size_t position);
+
+/* 
+DESCRIPTION
+	Returns the index of the task stored by TaskSetPosition.
+RETURN
+	Index of the task, TASK_NO_POSITION if it wasn't set.
+INPUT
+	task: pointer to the task.
+*/
+size_t TaskGetPosition(const task_t *task);
+
 #endif /* __NSRD_TASK_H__ */
 
@@ -10,6 +10,8 @@
 * 
 *******************************************************************************/
 
+#define _POSIX_C_SOURCE 200112L
+
 #include <stdlib.h> /* free */
 #include <unistd.h> /* sleep */
 
@@ -40,6 +42,7 @@ static void TestTaskCompare(void);
 static void TestTaskGetUID(void);
 static void TestTaskGetExecutionTime(void);
 static void TestTaskUpdateExecTime(void);
+static long TimespecDiffNs(const struct timespec *t1, const struct timespec *t2);
 
 int main()
 {
@@ -85,7 +88,9 @@ static void TestTaskCompare(void)
 	TH_ASSERT(0 == TaskCompare(task, task));
 	TH_ASSERT(0 < TaskCompare(task, task2));
 	TH_ASSERT(0 > TaskCompare(task2, task));
-	TH_ASSERT(0 == TaskCompare(task2, task3));
+	/* same interval, task3 is created later, so its deadline is later */
+	TH_ASSERT(0 < TaskCompare(task2, task3));
+	TH_ASSERT(0 > TaskCompare(task3, task2));
 
 	TaskDestroy(task);
 	TaskDestroy(task2);
@@ -123,10 +128,19 @@ static op_status_t ExecIncr(void *operation_params)
 static void TestTaskGetExecutionTime(void)
 {
 	op_params_container_t box = {IncrInt, 0, NULL};
+	struct timespec before = {0};
+	struct timespec after = {0};
+	struct timespec time_task = {0};
+	task_t *task = NULL;
 
-	task_t *task = TaskCreate(ExecIncr, Cleanup, &box, NULL, 0);
+	clock_gettime(CLOCK_MONOTONIC, &before);
+	task = TaskCreate(ExecIncr, Cleanup, &box, NULL, 0);
+	clock_gettime(CLOCK_MONOTONIC, &after);
 
-	TH_ASSERT(time(NULL) == TaskGetExecutionTime(task));
+	time_task = TaskGetExecutionTime(task);
+
+	TH_ASSERT(0 <= TimespecDiffNs(&time_task, &before));
+	TH_ASSERT(0 <= TimespecDiffNs(&after, &time_task));
 
 	TaskDestroy(task);
 }
@@ -134,19 +148,31 @@ static void TestTaskGetExecutionTime(void)
 static void TestTaskUpdateExecTime(void)
 {
 	op_params_container_t box = {IncrInt, 0, NULL};
-	task_t *task = TaskCreate(ExecIncr, Cleanup, &box, NULL, 0);
-	time_t time_task = TaskGetExecutionTime(task);
-	time_t time_now = time(NULL);
+	task_t *task = TaskCreate(ExecIncr, Cleanup, &box, NULL, 2);
+	struct timespec time_now = {0};
+	struct timespec time_task = TaskGetExecutionTime(task);
 
-	TH_ASSERT(0.0 == difftime(time_now, time_task));
+	clock_gettime(CLOCK_MONOTONIC, &time_now);
+	TH_ASSERT(0 < TimespecDiffNs(&time_task, &time_now));
+	TH_ASSERT(2000000000L >= TimespecDiffNs(&time_task, &time_now));
 
-	sleep(2);
-	time_now = time(NULL);
-	TH_ASSERT(0.0 == difftime(time_now, (TaskGetExecutionTime(task) + 2)));
+	sleep(1);
+	TH_ASSERT(0 == TaskUpdateExecTime(task));
+	clock_gettime(CLOCK_MONOTONIC, &time_now);
+	time_task = TaskGetExecutionTime(task);
+
+	TH_ASSERT(1900000000L < TimespecDiffNs(&time_task, &time_now));
+	TH_ASSERT(2000000000L >= TimespecDiffNs(&time_task, &time_now));
 
 	TaskDestroy(task);
 }
 
+static long TimespecDiffNs(const struct timespec *t1, const struct timespec *t2)
+{
+	return ((t1->tv_sec - t2->tv_sec) * 1000000000L
+										+ (t1->tv_nsec - t2->tv_nsec));
+}
+
 static void TestTaskGetUID(void)
 {
 	op_params_container_t box = {IncrInt, 0, NULL};
@@ -0,0 +1,434 @@
+/*******************************************************************************
+*
+* FILENAME : timing_wheel.c
+*
+* DESCRIPTION : Hierarchical timing wheel implementation.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#include <assert.h> /* assert */
+#include <stdlib.h> /* malloc, free */
+
+#include "timing_wheel.h"
+
+#define LEVELS (5)
+#define SLOT_BITS (6)
+#define SLOTS (1 << SLOT_BITS)
+#define SLOT_MASK (SLOTS - 1)
+#define MAX_DELTA ((1UL << (SLOT_BITS * LEVELS)) - 1)
+
+#define LEVEL_SHIFT(level) ((level) * SLOT_BITS)
+#define LEVEL_RANGE(level) (1UL << LEVEL_SHIFT((level) + 1))
+
+struct tw_timer
+{
+    tw_timer_t next;
+    tw_timer_t prev;
+    void *data;
+    unsigned long expiry;
+};
+
+struct timing_wheel
+{
+    struct tw_timer slots[LEVELS][SLOTS];
+    struct tw_timer expired;
+    tw_timer_t free_timers;
+    unsigned long next_tick;
+    size_t size;
+};
+
+static void ListInit(tw_timer_t head);
+static int ListIsEmpty(const struct tw_timer *head);
+static void ListAppend(tw_timer_t head, tw_timer_t timer);
+static void ListUnlink(tw_timer_t timer);
+static void ListSpliceTail(tw_timer_t dest, tw_timer_t src);
+static void PlaceTimer(timing_wheel_t *wheel, tw_timer_t timer,
+                                                    unsigned long next_tick);
+static void CascadeSlot(timing_wheel_t *wheel, tw_timer_t slot,
+                                                    unsigned long next_tick);
+static int FindNextEventTick(const timing_wheel_t *wheel, unsigned long *tick);
+static void FreeList(tw_timer_t head);
+static tw_timer_t AllocTimer(timing_wheel_t *wheel);
+static void ReleaseTimer(timing_wheel_t *wheel, tw_timer_t timer);
+
+timing_wheel_t *TimingWheelCreate(void)
+{
+    size_t level = 0;
+    size_t slot = 0;
+
+    timing_wheel_t *new_wheel = (timing_wheel_t *)
+                                            malloc(sizeof(timing_wheel_t));
+    if (NULL == new_wheel)
+    {
+        return (NULL);
+    }
+
+    for (level = 0; level < LEVELS; ++level)
+    {
+        for (slot = 0; slot < SLOTS; ++slot)
+        {
+            ListInit(&new_wheel->slots[level][slot]);
+        }
+    }
+
+    ListInit(&new_wheel->expired);
+    new_wheel->free_timers = NULL;
+    new_wheel->next_tick = 0;
+    new_wheel->size = 0;
+
+    return (new_wheel);
+}
+
+void TimingWheelDestroy(timing_wheel_t *wheel)
+{
+    assert(NULL != wheel);
+
+    TimingWheelClear(wheel);
+
+    while (NULL != wheel->free_timers)
+    {
+        tw_timer_t timer = wheel->free_timers;
+
+        wheel->free_timers = timer->next;
+        free(timer);
+    }
+
+    free(wheel);
+    wheel = NULL;
+}
+
+tw_timer_t TimingWheelAdd(timing_wheel_t *wheel, void *data,
+                                                    unsigned long expiry_tick)
+{
+    tw_timer_t timer = NULL;
+
+    assert(NULL != wheel);
+
+    timer = AllocTimer(wheel);
+    if (NULL == timer)
+    {
+        return (NULL);
+    }
+
+    timer->data = data;
+    timer->expiry = expiry_tick;
+
+    PlaceTimer(wheel, timer, wheel->next_tick);
+    ++wheel->size;
+
+    return (timer);
+}
+
+void *TimingWheelRemove(timing_wheel_t *wheel, tw_timer_t timer)
+{
+    void *data = NULL;
+
+    assert(NULL != wheel);
+    assert(NULL != timer);
+
+    data = timer->data;
+
+    ListUnlink(timer);
+    ReleaseTimer(wheel, timer);
+    timer = NULL;
+
+    --wheel->size;
+
+    return (data);
+}
+
+void *TimingWheelPopExpired(timing_wheel_t *wheel)
+{
+    assert(NULL != wheel);
+
+    if (ListIsEmpty(&wheel->expired))
+    {
+        return (NULL);
+    }
+
+    return (TimingWheelRemove(wheel, wheel->expired.next));
+}
+
+void TimingWheelAdvance(timing_wheel_t *wheel, unsigned long tick)
+{
+    assert(NULL != wheel);
+
+    while (wheel->next_tick <= tick)
+    {
+        unsigned long next_tick = 0;
+        size_t level = 1;
+
+        /* nothing happens on the ticks before the next event, skip them */
+        if (!FindNextEventTick(wheel, &next_tick) || tick < next_tick)
+        {
+            wheel->next_tick = tick + 1;
+            break;
+        }
+
+        if (0 == (next_tick & SLOT_MASK))
+        {
+            for (level = 1; level < LEVELS; ++level)
+            {
+                size_t slot = (next_tick >> LEVEL_SHIFT(level)) & SLOT_MASK;
+
+                CascadeSlot(wheel, &wheel->slots[level][slot], next_tick);
+
+                if (0 != slot)
+                {
+                    break;
+                }
+            }
+        }
+
+        ListSpliceTail(&wheel->expired,
+                       &wheel->slots[0][next_tick & SLOT_MASK]);
+
+        wheel->next_tick = next_tick + 1;
+    }
+}
+
+unsigned long TimingWheelNextTick(const timing_wheel_t *wheel)
+{
+    unsigned long next_tick = 0;
+
+    assert(NULL != wheel);
+    assert(0 < wheel->size);
+
+    if (!ListIsEmpty(&wheel->expired)
+     || !FindNextEventTick(wheel, &next_tick))
+    {
+        return (wheel->next_tick);
+    }
+
+    return (next_tick);
+}
+
+int TimingWheelForEach(timing_wheel_t *wheel,
+                       timing_wheel_action_func_t action, void *param)
+{
+    size_t level = 0;
+    size_t slot = 0;
+    int status = 0;
+    tw_timer_t runner = NULL;
+
+    assert(NULL != wheel);
+    assert(NULL != action);
+
+    for (runner = wheel->expired.next; runner != &wheel->expired;
+                                                        runner = runner->next)
+    {
+        status |= action(runner->data, param);
+    }
+
+    for (level = 0; level < LEVELS; ++level)
+    {
+        for (slot = 0; slot < SLOTS; ++slot)
+        {
+            tw_timer_t head = &wheel->slots[level][slot];
+
+            for (runner = head->next; runner != head; runner = runner->next)
+            {
+                status |= action(runner->data, param);
+            }
+        }
+    }
+
+    return (status);
+}
+
+size_t TimingWheelSize(const timing_wheel_t *wheel)
+{
+    assert(NULL != wheel);
+
+    return (wheel->size);
+}
+
+int TimingWheelIsEmpty(const timing_wheel_t *wheel)
+{
+    assert(NULL != wheel);
+
+    return (0 == wheel->size);
+}
+
+void TimingWheelClear(timing_wheel_t *wheel)
+{
+    size_t level = 0;
+    size_t slot = 0;
+
+    assert(NULL != wheel);
+
+    FreeList(&wheel->expired);
+
+    for (level = 0; level < LEVELS; ++level)
+    {
+        for (slot = 0; slot < SLOTS; ++slot)
+        {
+            FreeList(&wheel->slots[level][slot]);
+        }
+    }
+
+    wheel->size = 0;
+}
+
+static void PlaceTimer(timing_wheel_t *wheel, tw_timer_t timer,
+                                                    unsigned long next_tick)
+{
+    unsigned long tick = timer->expiry;
+    unsigned long delta = 0;
+    size_t level = 0;
+
+    if (tick < next_tick)
+    {
+        ListAppend(&wheel->expired, timer);
+        return;
+    }
+
+    delta = tick - next_tick;
+
+    /* too far timers wait in the farthest slot and get placed again there */
+    if (MAX_DELTA < delta)
+    {
+        delta = MAX_DELTA;
+        tick = next_tick + MAX_DELTA;
+    }
+
+    while (LEVEL_RANGE(level) <= delta)
+    {
+        ++level;
+    }
+
+    ListAppend(&wheel->slots[level][(tick >> LEVEL_SHIFT(level)) & SLOT_MASK],
+                                                                        timer);
+}
+
+static void CascadeSlot(timing_wheel_t *wheel, tw_timer_t slot,
+                                                    unsigned long next_tick)
+{
+    struct tw_timer pending = {0};
+
+    ListInit(&pending);
+    ListSpliceTail(&pending, slot);
+
+    while (!ListIsEmpty(&pending))
+    {
+        tw_timer_t timer = pending.next;
+
+        ListUnlink(timer);
+        PlaceTimer(wheel, timer, next_tick);
+    }
+}
+
+static int FindNextEventTick(const timing_wheel_t *wheel, unsigned long *tick)
+{
+    unsigned long next_tick = wheel->next_tick;
+    int is_found = 0;
+    size_t level = 0;
+    size_t k = 0;
+
+    for (level = 0; level < LEVELS; ++level)
+    {
+        size_t shift = LEVEL_SHIFT(level);
+        unsigned long base = next_tick >> shift;
+        size_t first = (0 == (next_tick & ((1UL << shift) - 1))) ? 0 : 1;
+
+        for (k = first; k < first + SLOTS; ++k)
+        {
+            unsigned long slot_tick = (base + k) << shift;
+
+            if (is_found && *tick <= slot_tick)
+            {
+                break;
+            }
+
+            if (!ListIsEmpty(&wheel->slots[level][(base + k) & SLOT_MASK]))
+            {
+                *tick = slot_tick;
+                is_found = 1;
+                break;
+            }
+        }
+    }
+
+    return (is_found);
+}
+
+static void ListInit(tw_timer_t head)
+{
+    head->next = head;
+    head->prev = head;
+    head->data = NULL;
+    head->expiry = 0;
+}
+
+static int ListIsEmpty(const struct tw_timer *head)
+{
+    return (head->next == head);
+}
+
+static void ListAppend(tw_timer_t head, tw_timer_t timer)
+{
+    timer->prev = head->prev;
+    timer->next = head;
+    head->prev->next = timer;
+    head->prev = timer;
+}
+
+static void ListUnlink(tw_timer_t timer)
+{
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->next = timer;
+    timer->prev = timer;
+}
+
+static void ListSpliceTail(tw_timer_t dest, tw_timer_t src)
+{
+    if (ListIsEmpty(src))
+    {
+        return;
+    }
+
+    src->next->prev = dest->prev;
+    dest->prev->next = src->next;
+    src->prev->next = dest;
+    dest->prev = src->prev;
+
+    src->next = src;
+    src->prev = src;
+}
+
+/* removed timers are kept for reuse, so rescheduling doesn't allocate */
+static tw_timer_t AllocTimer(timing_wheel_t *wheel)
+{
+    tw_timer_t timer = wheel->free_timers;
+
+    if (NULL == timer)
+    {
+        return ((tw_timer_t)malloc(sizeof(struct tw_timer)));
+    }
+
+    wheel->free_timers = timer->next;
+
+    return (timer);
+}
+
+static void ReleaseTimer(timing_wheel_t *wheel, tw_timer_t timer)
+{
+    timer->next = wheel->free_timers;
+    wheel->free_timers = timer;
+}
+
+static void FreeList(tw_timer_t head)
+{
+    while (!ListIsEmpty(head))
+    {
+        tw_timer_t timer = head->next;
+
+        ListUnlink(timer);
+        free(timer);
+    }
+}
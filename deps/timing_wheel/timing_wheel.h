@@ -0,0 +1,198 @@
+/*******************************************************************************
+*
+* FILENAME : timing_wheel.h
+*
+* DESCRIPTION : Hierarchical timing wheel keeps timers in several levels of
+* circular buffers of slots. Every level covers a range of ticks that is
+* 64 times wider than the level below it. Timers are added and removed in
+* constant time, and are moved ("cascaded") to a lower level when the time
+* reaches their slot, until they expire.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_TIMING_WHEEL_H__
+#define __NSRD_TIMING_WHEEL_H__
+
+#include <stddef.h> /* size_t */
+
+typedef struct timing_wheel timing_wheel_t;
+typedef struct tw_timer *tw_timer_t;
+
+/*
+DESCRIPTION
+    Pointer to the user's function that executes an action on data using the
+    param. The actual action and types of the input are defined by the user.
+RETURN
+    0: success.
+    non-zero: fail.
+INPUT
+    data: pointer to the user's data.
+    param: pointer to the parameter.
+*/
+typedef int (*timing_wheel_action_func_t)(void *data, void *param);
+
+/*
+DESCRIPTION
+    Creates new timing wheel. The current tick of the wheel is 0.
+    Creation may fail, due to memory allocation fail.
+    User is responsible for memory deallocation.
+RETURN
+    Pointer to the created timing wheel on success.
+    NULL if allocation failed.
+INPUT
+    Doesn't receive anything.
+TIME COMPLEXITY:
+    O(1)
+*/
+timing_wheel_t *TimingWheelCreate(void);
+
+/*
+DESCRIPTION
+    Frees the memory allocated for the timing wheel and its timers,
+    including the storage kept for reuse.
+    The user's data is not freed.
+RETURN
+    Doesn't return anything.
+INPUT
+    wheel: pointer to the timing wheel.
+TIME COMPLEXITY:
+    O(n)
+*/
+void TimingWheelDestroy(timing_wheel_t *wheel);
+
+/*
+DESCRIPTION
+    Adds a timer that expires on the passed tick. A timer whose tick has
+    already passed expires immediately. Storage of removed timers is reused,
+    so adding doesn't allocate while the wheel is not larger than it was.
+    Addition may fail, due to memory allocation fail.
+RETURN
+    Handle of the timer on success.
+    NULL on failure.
+INPUT
+    wheel: pointer to the timing wheel.
+    data: pointer to the user's data.
+    expiry_tick: tick on which the timer expires.
+TIME COMPLEXITY:
+    O(1)
+*/
+tw_timer_t TimingWheelAdd(timing_wheel_t *wheel, void *data,
+                                                    unsigned long expiry_tick);
+
+/*
+DESCRIPTION
+    Removes the timer from the timing wheel. Passing a handle of a timer
+    which was already popped or removed is undefined behavior.
+RETURN
+    Pointer to the user's data of the removed timer.
+INPUT
+    wheel: pointer to the timing wheel.
+    timer: handle of the timer.
+TIME COMPLEXITY:
+    O(1)
+*/
+void *TimingWheelRemove(timing_wheel_t *wheel, tw_timer_t timer);
+
+/*
+DESCRIPTION
+    Removes one of the expired timers. Timers expired on the same tick are
+    popped in the order of addition.
+RETURN
+    Pointer to the user's data of the removed timer.
+    NULL if there are no expired timers.
+INPUT
+    wheel: pointer to the timing wheel.
+TIME COMPLEXITY:
+    O(1)
+*/
+void *TimingWheelPopExpired(timing_wheel_t *wheel);
+
+/*
+DESCRIPTION
+    Moves the current tick of the wheel forward up to and including the
+    passed tick, expiring the timers on the way. Passing a tick that has
+    already passed does nothing.
+RETURN
+    Doesn't return anything.
+INPUT
+    wheel: pointer to the timing wheel.
+    tick: tick to advance the wheel to.
+TIME COMPLEXITY:
+    O(ticks passed + timers cascaded)
+*/
+void TimingWheelAdvance(timing_wheel_t *wheel, unsigned long tick);
+
+/*
+DESCRIPTION
+    Returns the earliest tick on which advancing the wheel may expire or
+    cascade a timer. If there are expired timers already, returns the next
+    tick to be processed. Calling on an empty wheel is undefined behavior.
+RETURN
+    The tick to advance the wheel to.
+INPUT
+    wheel: pointer to the timing wheel.
+TIME COMPLEXITY:
+    O(levels * slots)
+*/
+unsigned long TimingWheelNextTick(const timing_wheel_t *wheel);
+
+/*
+DESCRIPTION
+    Traverses all the timers of the wheel and calls user's action function
+    passing timer's data and param as input. The action must not add or
+    remove timers.
+RETURN
+    0: no actions failed.
+    non-zero: at least one action failed.
+INPUT
+    wheel: pointer to the timing wheel.
+    action: user's function that executes an action.
+    param: parameter for the action function.
+TIME COMPLEXITY:
+    O(n)
+*/
+int TimingWheelForEach(timing_wheel_t *wheel,
+                       timing_wheel_action_func_t action, void *param);
+
+/*
+DESCRIPTION
+    Returns the amount of timers in the timing wheel.
+RETURN
+    Number of timers in the timing wheel.
+INPUT
+    wheel: pointer to the timing wheel.
+TIME COMPLEXITY:
+    O(1)
+*/
+size_t TimingWheelSize(const timing_wheel_t *wheel);
+
+/*
+DESCRIPTION
+    Checks if the timing wheel is empty.
+RETURN
+    1: empty.
+    0: is not empty.
+INPUT
+    wheel: pointer to the timing wheel.
+TIME COMPLEXITY:
+    O(1)
+*/
+int TimingWheelIsEmpty(const timing_wheel_t *wheel);
+
+/*
+DESCRIPTION
+    Removes all timers from the timing wheel.
+RETURN
+    Doesn't return anything.
+INPUT
+    wheel: pointer to the timing wheel.
+TIME COMPLEXITY:
+    O(n)
+*/
+void TimingWheelClear(timing_wheel_t *wheel);
+
+#endif  /* __NSRD_TIMING_WHEEL_H__ */
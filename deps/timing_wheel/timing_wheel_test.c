@@ -0,0 +1,205 @@
+/*******************************************************************************
+*
+* FILENAME : timing_wheel_test.c
+*
+* DESCRIPTION : Hierarchical timing wheel unit tests.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#include <stdlib.h> /* rand, srand */
+
+#include "timing_wheel.h"
+#include "testing.h"
+
+#define RANDOM_AMOUNT (10000)
+
+typedef struct timer_data
+{
+	unsigned long expiry;
+	tw_timer_t handle;
+} timer_data_t;
+
+static int CountTimers(void *data, void *param);
+static unsigned long RandomExpiry(void);
+
+static void TestTimingWheelGeneral(void);
+static void TestTimingWheelRemove(void);
+static void TestTimingWheelOrder(void);
+static void TestTimingWheelRandom(void);
+
+int main()
+{
+	TH_TEST_T TESTS[] = {
+		{"General", TestTimingWheelGeneral},
+		{"Remove", TestTimingWheelRemove},
+		{"Order", TestTimingWheelOrder},
+		{"Random", TestTimingWheelRandom},
+		TH_TESTS_ARRAY_END
+	};
+
+	TH_RUN_TESTS(TESTS);
+
+	return (0);
+}
+
+static void TestTimingWheelGeneral(void)
+{
+	int a = 1, b = 2, c = 3;
+
+	timing_wheel_t *wheel = TimingWheelCreate();
+
+	TH_ASSERT(NULL != wheel);
+	TH_ASSERT(1 == TimingWheelIsEmpty(wheel));
+
+	TH_ASSERT(NULL != TimingWheelAdd(wheel, &a, 10));
+	TH_ASSERT(NULL != TimingWheelAdd(wheel, &b, 100));
+	TH_ASSERT(NULL != TimingWheelAdd(wheel, &c, 100000));
+	TH_ASSERT(3 == TimingWheelSize(wheel));
+
+	TH_ASSERT(10 == TimingWheelNextTick(wheel));
+	TH_ASSERT(NULL == TimingWheelPopExpired(wheel));
+
+	TimingWheelAdvance(wheel, 9);
+	TH_ASSERT(NULL == TimingWheelPopExpired(wheel));
+
+	TimingWheelAdvance(wheel, 10);
+	TH_ASSERT(&a == TimingWheelPopExpired(wheel));
+	TH_ASSERT(NULL == TimingWheelPopExpired(wheel));
+	TH_ASSERT(2 == TimingWheelSize(wheel));
+
+	TimingWheelAdvance(wheel, 99999);
+	TH_ASSERT(&b == TimingWheelPopExpired(wheel));
+	TH_ASSERT(NULL == TimingWheelPopExpired(wheel));
+
+	TimingWheelAdvance(wheel, 100000);
+	TH_ASSERT(&c == TimingWheelPopExpired(wheel));
+	TH_ASSERT(1 == TimingWheelIsEmpty(wheel));
+
+	TH_ASSERT(NULL != TimingWheelAdd(wheel, &a, 5));
+	TH_ASSERT(&a == TimingWheelPopExpired(wheel));
+
+	TH_ASSERT(NULL != TimingWheelAdd(wheel, &a, 200000));
+	TH_ASSERT(NULL != TimingWheelAdd(wheel, &b, 300000));
+	TimingWheelClear(wheel);
+	TH_ASSERT(1 == TimingWheelIsEmpty(wheel));
+
+	TimingWheelDestroy(wheel);
+}
+
+static void TestTimingWheelRemove(void)
+{
+	int a = 1, b = 2;
+	size_t counter = 0;
+	tw_timer_t timer_a = NULL;
+
+	timing_wheel_t *wheel = TimingWheelCreate();
+
+	timer_a = TimingWheelAdd(wheel, &a, 5000);
+	TimingWheelAdd(wheel, &b, 5000);
+
+	TimingWheelForEach(wheel, CountTimers, &counter);
+	TH_ASSERT(2 == counter);
+
+	TH_ASSERT(&a == TimingWheelRemove(wheel, timer_a));
+	TH_ASSERT(1 == TimingWheelSize(wheel));
+
+	TimingWheelAdvance(wheel, 5000);
+	TH_ASSERT(&b == TimingWheelPopExpired(wheel));
+	TH_ASSERT(NULL == TimingWheelPopExpired(wheel));
+
+	TimingWheelDestroy(wheel);
+}
+
+static void TestTimingWheelOrder(void)
+{
+	int arr[5] = {0, 1, 2, 3, 4};
+	size_t i = 0;
+	int is_ordered = 1;
+
+	timing_wheel_t *wheel = TimingWheelCreate();
+
+	for (i = 0; i < 5; ++i)
+	{
+		TimingWheelAdd(wheel, arr + i, 7000);
+	}
+
+	TimingWheelAdvance(wheel, 7000);
+
+	for (i = 0; i < 5; ++i)
+	{
+		is_ordered &= (arr + i == TimingWheelPopExpired(wheel));
+	}
+
+	TH_ASSERT(is_ordered);
+
+	TimingWheelDestroy(wheel);
+}
+
+static void TestTimingWheelRandom(void)
+{
+	static timer_data_t timers[RANDOM_AMOUNT];
+	size_t i = 0;
+	size_t popped = 0;
+	unsigned long prev_tick = 0;
+	int is_in_time = 1;
+
+	timing_wheel_t *wheel = TimingWheelCreate();
+
+	srand(RANDOM_AMOUNT);
+
+	for (i = 0; i < RANDOM_AMOUNT; ++i)
+	{
+		timers[i].expiry = RandomExpiry() + 1;
+		timers[i].handle = TimingWheelAdd(wheel, timers + i, timers[i].expiry);
+	}
+
+	for (i = 0; i < RANDOM_AMOUNT; i += 10)
+	{
+		TimingWheelRemove(wheel, timers[i].handle);
+	}
+
+	TimingWheelAdvance(wheel, 0);
+
+	while (!TimingWheelIsEmpty(wheel))
+	{
+		unsigned long tick = TimingWheelNextTick(wheel);
+		timer_data_t *timer = NULL;
+
+		is_in_time &= (prev_tick < tick);
+
+		TimingWheelAdvance(wheel, tick);
+
+		while (NULL != (timer = TimingWheelPopExpired(wheel)))
+		{
+			is_in_time &= (prev_tick < timer->expiry && timer->expiry <= tick);
+			++popped;
+		}
+
+		prev_tick = tick;
+	}
+
+	TH_ASSERT(is_in_time);
+	TH_ASSERT(RANDOM_AMOUNT - RANDOM_AMOUNT / 10 == popped);
+
+	TimingWheelDestroy(wheel);
+}
+
+static int CountTimers(void *data, void *param)
+{
+	++*(size_t *)param;
+
+	return (0);
+	(void) data;
+}
+
+static unsigned long RandomExpiry(void)
+{
+	unsigned long ranges[5] = {64, 4096, 1UL << 20, 1UL << 30, 1UL << 40};
+	unsigned long range = ranges[rand() % 5];
+
+	return ((((unsigned long)rand() << 31) | (unsigned long)rand()) % range);
+}
@@ -14,7 +14,8 @@
 #define __NSRD_WATCHDOG_H__
 
 #include <stddef.h>
-#include <semaphore.h>
+#include <time.h> /* struct timespec */
+#include <sys/types.h> /* pid_t */
 #include <pthread.h>
 
 #ifndef NDEBUG
@@ -23,6 +24,208 @@
 #define PATH_TO_WATCHDOG ("../watchdog.out")
 #endif
 
+#define WD_MIN_DOWNTIME_MS (100)
+#define WD_HISTORY_SIZE (32)
+#define WD_MAX_HANDLES (64)
+#define WD_MAX_THREADS (64)
+#define WD_MAX_LISTENERS (16)
+#define WD_MAX_RECORDERS (16)
+#define WD_RECORDER_EVENTS (256)
+
+typedef struct wd wd_t;
+typedef struct wd_thread wd_thread_t;
+typedef struct wd_recorder wd_recorder_t;
+
+/*
+DESCRIPTION
+	The way the watchdog and the program prove to each other they are alive.
+	WD_HEARTBEAT_SIGNAL: the sides send each other SIGUSR1 every kick
+	interval. Blocking system calls of the program may fail with EINTR.
+	WD_HEARTBEAT_SHARED_MEMORY: the sides increment sequence counters in a
+	shared memory page and compare the counters of each other. No signals
+	are sent while the sides are alive.
+*/
+typedef enum wd_heartbeat
+{
+	WD_HEARTBEAT_SIGNAL,
+	WD_HEARTBEAT_SHARED_MEMORY
+} wd_heartbeat_t;
+
+/*
+DESCRIPTION
+	The way a process is started when the program or the watchdog has to be
+	restarted.
+	WD_SPAWN_FORK: fork and execvp. Fork copies the page tables of the
+	caller, which is slow for processes with a large resident set and may
+	fail under strict overcommit limits.
+	WD_SPAWN_POSIX_SPAWN: posix_spawnp, which doesn't copy the address space.
+	WD_SPAWN_VFORK: vfork and execvp. The caller is suspended until the new
+	process calls execvp.
+*/
+typedef enum wd_spawn
+{
+	WD_SPAWN_FORK,
+	WD_SPAWN_POSIX_SPAWN,
+	WD_SPAWN_VFORK
+} wd_spawn_t;
+
+/*
+DESCRIPTION
+	Options of the watchdog passed to WDStartEx. Fields that are left zero
+	get their default values.
+FIELDS
+	downtime_ms - the time interval in milliseconds for which the system is
+	allowed to not respond. The value should be no less than
+	WD_MIN_DOWNTIME_MS.
+	kicktime_ms - the interval in milliseconds between the kicks that the
+	watchdog and the program send each other. Should be less than
+	downtime_ms. Default: downtime_ms / 5.
+	heartbeat - the way of kicking. Default: WD_HEARTBEAT_SIGNAL.
+	spawn - the way of starting processes. Default: WD_SPAWN_FORK.
+	supervisor - path of the socket of a supervisor started by WDSupervise.
+	If set, the program registers with the supervisor and kicks it instead
+	of spawning its own watchdog process, heartbeat and spawn are ignored
+	then. Default: NULL.
+	max_restarts - the number of restarts allowed within restart_window_ms.
+	When it is reached the restarts are given up. No more than
+	WD_HISTORY_SIZE, the handle is not created otherwise. Default: 0,
+	unlimited.
+	restart_window_ms - the sliding window in milliseconds the restarts are
+	counted in. Default: 60000.
+	backoff_min_ms - the delay of the second restart within the window. The
+	first restart is immediate, every next one waits twice as long, up to
+	backoff_max_ms, and a random part of up to a half of the delay is cut
+	off. Default: 0, the restarts are immediate.
+	backoff_max_ms - the limit of the delay of a restart. Default: 30000.
+	on_give_up - function called in the program when it gives up restarting
+	the watchdog. When the watchdog gives up restarting the program, it
+	records it in the restart history and exits. Default: NULL.
+	give_up_param - parameter passed to on_give_up.
+	is_app_kicked - 1 if the program has to call WDKick itself, otherwise
+	it is restarted as hung. The calls should be no more than
+	downtime_ms - kicktime_ms apart. Default: 0, the watchdog is kicked by
+	its own thread of the program, which keeps kicking while the rest of
+	the program hangs.
+	phi_threshold - suspicion at which the peer is restarted as hung,
+	instead of when it doesn't kick for downtime_ms. The suspicion grows the
+	later the next kick is compared to the intervals between the kicks seen
+	so far, the peer is suspected wrongly with a probability of 10^-phi.
+	8 is a common choice, higher values tolerate longer pauses. downtime_ms
+	is still used until enough kicks are seen, and for the first kick of a
+	new peer. Default: 0, only downtime_ms is used.
+	progress_window_ms - the time in milliseconds for which the program is
+	allowed to kick without reporting progress with WDProgress. A program
+	that keeps kicking but stops making progress, like a livelocked one, is
+	restarted as hung then. A program that may be idle for longer should
+	report the idle iterations as progress too. Default: 0, the progress
+	isn't checked.
+	is_hot_standby - 1 if the watchdog keeps a second instance of the
+	program started in advance and promotes it the moment the program dies
+	or hangs, then starts a new standby. The standby runs like a restarted
+	program until it calls WDAwaitPromotion, which it should call once it
+	has warmed up and before it does any work. A standby that hasn't called
+	it yet when the program dies is replaced by a usual restart. Only the
+	handle that restarts the program keeps a standby. Default: 0.
+*/
+typedef struct wd_options
+{
+	size_t downtime_ms;
+	size_t kicktime_ms;
+	wd_heartbeat_t heartbeat;
+	wd_spawn_t spawn;
+	const char *supervisor;
+	size_t max_restarts;
+	size_t restart_window_ms;
+	size_t backoff_min_ms;
+	size_t backoff_max_ms;
+	void (*on_give_up)(void *param);
+	void *give_up_param;
+	int is_app_kicked;
+	double phi_threshold;
+	size_t progress_window_ms;
+	int is_hot_standby;
+} wd_options_t;
+
+/*
+DESCRIPTION
+	State of the peer watched by a handle.
+	WD_STATUS_WATCHING: the peer is alive or is being checked.
+	WD_STATUS_RESTARTING: the peer is dead and its restart is delayed by the
+	backoff.
+	WD_STATUS_GAVE_UP: the peer crashed max_restarts times within the
+	restart window and isn't restarted anymore.
+*/
+typedef enum wd_status
+{
+	WD_STATUS_WATCHING,
+	WD_STATUS_RESTARTING,
+	WD_STATUS_GAVE_UP
+} wd_status_t;
+
+/*
+DESCRIPTION
+	Record of a restart of the program or of the watchdog process.
+FIELDS
+	is_watchdog - 1 if the watchdog process was restarted, 0 if the program.
+	is_hang - 1 if the process stopped sending kicks and was killed with
+	SIGKILL, 0 if it exited by itself.
+	pid - pid of the process that was restarted.
+	new_pid - pid of the process that replaced it.
+	is_status_known - 1 if the exit status was collected. Only the parent
+	of a process can collect it, the status of the program that started
+	the watchdog is collected by its own parent.
+	exit_code - exit code if the process exited normally, -1 otherwise.
+	term_signal - signal that terminated the process, 0 if it exited.
+	core_dumped - 1 if the process produced a core dump.
+	exit_time - CLOCK_REALTIME time the exit or the hang was noticed.
+	restart_time - CLOCK_REALTIME time the replacement was started.
+	is_given_up - 1 if the restarts were given up instead, new_pid is 0 and
+	restart_time is the time of giving up then.
+	is_stalled - 1 if the program kept kicking but made no progress for
+	progress_window_ms, is_hang is 1 then too.
+	is_standby - 1 if the program was replaced by the hot standby.
+	is_zygote - 1 if the program was forked by the zygote, see WDForkPoint.
+	The exit status of a forked program isn't known.
+*/
+typedef struct wd_restart_record
+{
+	int is_watchdog;
+	int is_hang;
+	pid_t pid;
+	pid_t new_pid;
+	int is_status_known;
+	int exit_code;
+	int term_signal;
+	int core_dumped;
+	struct timespec exit_time;
+	struct timespec restart_time;
+	int is_given_up;
+	int is_stalled;
+	int is_standby;
+	int is_zygote;
+} wd_restart_record_t;
+
+/*
+DESCRIPTION
+	Statistics of the intervals between the kicks received from the peer,
+	collected only while phi_threshold is set, all zero otherwise.
+FIELDS
+	samples - number of the last intervals the statistics are taken from.
+	mean_ms - mean interval in milliseconds.
+	stddev_ms - standard deviation of the intervals in milliseconds, no
+	less than a quarter of the mean.
+	phi - the current suspicion of the peer, 0 until enough kicks are seen.
+	max_phi - the highest suspicion seen so far.
+*/
+typedef struct wd_detector_stats
+{
+	size_t samples;
+	double mean_ms;
+	double stddev_ms;
+	double phi;
+	double max_phi;
+} wd_detector_stats_t;
+
 /* 
 DESCRIPTION
 	Starts a background process named "watchdog" that will watch over user's 
@@ -45,11 +248,50 @@ INPUT
 */
 int WDStart(int argc, char *argv[], size_t downtime);
 
+/* 
+DESCRIPTION
+	Same as WDStart, but the watchdog is configured by the options, which
+	allow the downtime and the kick interval to be set in milliseconds.
+RETURN	
+	0 - on success
+	1 - on failure to start the watchdog.
+INPUT
+	argc - number of the command line arguments. This is the main function 
+	parameter that should be passed to WDStartEx.
+	argv - array of strings with command line arguments. This is the main 
+	function parameter that should be passed to WDStartEx.
+	options - pointer to the options of the watchdog. The options are copied,
+	so they may be released after the function returns.
+*/
+int WDStartEx(int argc, char *argv[], const wd_options_t *options);
+
+/*
+DESCRIPTION
+	Same as WDStartEx, but returns without waiting for the watchdog to come
+	up. The program is watched from the moment on_ready is called with
+	status 0. on_ready is called once, from the watchdog thread of the
+	program, and should return quickly.
+RETURN
+	0 - on success
+	1 - on failure to start the watchdog.
+INPUT
+	argc - number of the command line arguments.
+	argv - array of strings with command line arguments.
+	options - pointer to the options of the watchdog.
+	on_ready - function called when the watchdog is up with status 0, or
+	with status 1 if it didn't come up within the downtime, in which case
+	it keeps being restarted. May be NULL.
+	param - parameter passed to on_ready.
+*/
+int WDStartAsync(int argc, char *argv[], const wd_options_t *options,
+                 void (*on_ready)(int status, void *param), void *param);
+
 /*
 DESCRIPTION
 	Stops the watchdog and frees resources. It should not be run if WDStart
 	returned 1 (failed to start ther watchdog) because all the resourses
-	will be cleaned up on failure.
+	will be cleaned up on failure. Returns as soon as the watchdog
+	acknowledges the stop, but waits no longer than 5 downtimes.
 RETURN	
 	There is no return for this function.
 INPUT
@@ -57,4 +299,437 @@ INPUT
 */
 void WDStop(void);
 
+/*
+DESCRIPTION
+	Same as WDStop, but waits for the acknowledgement of the watchdog no
+	longer than the passed timeout. A watchdog that doesn't acknowledge the
+	stop in time is killed.
+RETURN
+	0 - the watchdog acknowledged the stop.
+	1 - the watchdog didn't acknowledge the stop in time and was killed.
+INPUT
+	timeout_ms - the time in milliseconds to wait for the acknowledgement.
+*/
+int WDStopEx(size_t timeout_ms);
+
+/*
+DESCRIPTION
+	Copies the latest restarts of the program and of the watchdog, oldest
+	first. The history is shared by the program and the watchdog, so a
+	restarted program sees the restarts of its predecessors. Up to
+	WD_HISTORY_SIZE latest restarts of each process are kept.
+RETURN
+	Number of the records copied.
+INPUT
+	records - array to copy the records to.
+	max_records - capacity of the array.
+*/
+size_t WDGetRestartHistory(wd_restart_record_t *records, size_t max_records);
+
+/*
+DESCRIPTION
+	Creates a handle of a watchdog configured by the options. Handles are
+	independent: a program may watch several subsystems with different
+	downtimes, each by its own watchdog process. Up to WD_MAX_HANDLES
+	handles may exist at once.
+	Only the watchdog of the first created handle restarts the program
+	when it crashes or hangs, the watchdogs of the other handles exit
+	then and are spawned again by the restarted program. So a program that
+	uses several handles should create them in the same order on every
+	start. A handle takes the lowest free place among the WD_MAX_HANDLES,
+	so a handle created after the first one is destroyed takes over its
+	role.
+	User is responsible for destroying the handle.
+RETURN
+	Pointer to the handle on success.
+	NULL on failure.
+INPUT
+	options - pointer to the options of the watchdog. The options are copied,
+	so they may be released after the function returns.
+*/
+wd_t *WDCreate(const wd_options_t *options);
+
+/*
+DESCRIPTION
+	Frees the handle. A started handle should be stopped first. Waits for
+	the signal handlers running on other threads, which may still be
+	writing to the handle.
+RETURN
+	There is no return for this function.
+INPUT
+	wd - pointer to the handle, may be NULL.
+*/
+void WDDestroy(wd_t *wd);
+
+/*
+DESCRIPTION
+	Same as WDStartEx, but starts the watchdog of the handle.
+RETURN
+	0 - on success
+	1 - on failure to start the watchdog.
+INPUT
+	wd - pointer to the handle.
+	argc - number of the command line arguments.
+	argv - array of strings with command line arguments.
+*/
+int WDStartHandle(wd_t *wd, int argc, char *argv[]);
+
+/*
+DESCRIPTION
+	Same as WDStartAsync, but starts the watchdog of the handle.
+RETURN
+	0 - on success
+	1 - on failure to start the watchdog.
+INPUT
+	wd - pointer to the handle.
+	argc - number of the command line arguments.
+	argv - array of strings with command line arguments.
+	on_ready - function called when the watchdog is up, may be NULL.
+	param - parameter passed to on_ready.
+*/
+int WDStartHandleAsync(wd_t *wd, int argc, char *argv[],
+                       void (*on_ready)(int status, void *param), void *param);
+
+/*
+DESCRIPTION
+	Same as WDStopEx, but stops the watchdog of the handle. The handle may
+	be started again or destroyed afterwards.
+RETURN
+	0 - the watchdog acknowledged the stop.
+	1 - the watchdog didn't acknowledge the stop in time and was killed.
+INPUT
+	wd - pointer to the handle.
+	timeout_ms - the time in milliseconds to wait for the acknowledgement.
+*/
+int WDStopHandle(wd_t *wd, size_t timeout_ms);
+
+/*
+DESCRIPTION
+	Same as WDGetRestartHistory, but for the watchdog of the handle.
+RETURN
+	Number of the records copied.
+INPUT
+	wd - pointer to the handle.
+	records - array to copy the records to.
+	max_records - capacity of the array.
+*/
+size_t WDGetRestartHistoryHandle(const wd_t *wd, wd_restart_record_t *records,
+                                 size_t max_records);
+
+/*
+DESCRIPTION
+	Tells the watchdog started by WDStart or WDStartEx that the program is
+	alive, if it was started with is_app_kicked. Meant to be called from
+	the main loop of the program: it only increments a counter, without
+	locks or system calls. The watchdog thread of the program forwards the
+	kick to the watchdog on its next kick interval.
+RETURN
+	There is no return for this function.
+INPUT
+	There is no input for this function.
+*/
+void WDKick(void);
+
+/*
+DESCRIPTION
+	Same as WDKick, but kicks the watchdog of the handle.
+RETURN
+	There is no return for this function.
+INPUT
+	wd - pointer to the started handle.
+*/
+void WDKickHandle(wd_t *wd);
+
+/*
+DESCRIPTION
+	Reports progress of the program to the watchdog started by WDStart or
+	WDStartEx, like requests served or bytes processed. Only a change of the
+	total matters, so different kinds of work may be reported together.
+	It only adds to a counter, without locks or system calls. The counter
+	is carried to the watchdog by the kicks, to be checked against
+	progress_window_ms.
+RETURN
+	There is no return for this function.
+INPUT
+	amount - the amount of work done since the last report.
+*/
+void WDProgress(size_t amount);
+
+/*
+DESCRIPTION
+	Same as WDProgress, but reports to the watchdog of the handle.
+RETURN
+	There is no return for this function.
+INPUT
+	wd - pointer to the started handle.
+	amount - the amount of work done since the last report.
+*/
+void WDProgressHandle(wd_t *wd, size_t amount);
+
+/*
+DESCRIPTION
+	Returns a region of memory that outlives the program: the watchdog
+	holds it while the program is restarted, and the restarted program gets
+	the same contents by calling the function again. Hot state like
+	counters, sequence numbers and caches may be kept there to be resumed
+	instead of rebuilt. The region is zeroed when it is created, and grown
+	with zeroes if a restarted program asks for more. The program may die
+	in the middle of a write, so the contents should be checked before they
+	are resumed, with a version or a checksum for instance. The region is
+	unmapped when the watchdog is stopped. A program forked by the zygote
+	gets the region only if it was created before the fork point. Not
+	available with a supervisor.
+RETURN
+	Pointer to the region on success.
+	NULL if the handle isn't started, the region can't be created, or a
+	region smaller than size was already returned to this program.
+INPUT
+	size - size of the region in bytes.
+*/
+void *WDCheckpointRegion(size_t size);
+
+/*
+DESCRIPTION
+	Same as WDCheckpointRegion, but the region is held by the watchdog of
+	the handle.
+RETURN
+	Pointer to the region on success.
+	NULL on failure.
+INPUT
+	wd - pointer to the started handle.
+	size - size of the region in bytes.
+*/
+void *WDCheckpointRegionHandle(wd_t *wd, size_t size);
+
+/*
+DESCRIPTION
+	Registers the calling thread with the watchdog of the handle. The
+	thread gets its own heartbeat slot in the memory shared with the
+	watchdog and should call WDThreadKick at least once every deadline.
+	The watchdog checks the slots every kick interval. If a thread misses
+	its deadline, the program is restarted as hung, or the thread is only
+	reported late. Up to WD_MAX_THREADS threads may be registered with a
+	handle. Not available with a supervisor.
+RETURN
+	Pointer to the heartbeat slot of the thread on success.
+	NULL if there are no free slots or the handle isn't started.
+INPUT
+	wd - pointer to the started handle, NULL for the watchdog started by
+	WDStart or WDStartEx.
+	deadline_ms - the time in milliseconds the thread is allowed to not
+	kick. Should be no less than the kick interval.
+	is_report_only - 1 if a late thread should be reported by
+	WDIsThreadLate instead of restarting the program.
+*/
+wd_thread_t *WDRegisterThread(wd_t *wd, size_t deadline_ms,
+                              int is_report_only);
+
+/*
+DESCRIPTION
+	Tells the watchdog that the registered thread is alive. It only
+	increments a counter in the own cache line of the thread, without
+	locks or system calls. Should be called only by the registered thread.
+RETURN
+	There is no return for this function.
+INPUT
+	thread - pointer returned by WDRegisterThread.
+*/
+void WDThreadKick(wd_thread_t *thread);
+
+/*
+DESCRIPTION
+	Checks if the watchdog found the thread registered with is_report_only
+	late. The thread is no longer late once it kicks and the watchdog
+	notices it.
+RETURN
+	1 - the thread missed its deadline.
+	0 - the thread is on time.
+INPUT
+	thread - pointer returned by WDRegisterThread.
+*/
+int WDIsThreadLate(const wd_thread_t *thread);
+
+/*
+DESCRIPTION
+	Releases the heartbeat slot of the thread, the thread isn't watched
+	anymore. Should be called before the thread exits.
+RETURN
+	There is no return for this function.
+INPUT
+	thread - pointer returned by WDRegisterThread.
+*/
+void WDUnregisterThread(wd_thread_t *thread);
+
+/*
+DESCRIPTION
+	Gives the calling thread a flight recorder: a ring of the last
+	WD_RECORDER_EVENTS events in the memory shared with the watchdog. When
+	the program crashes or hangs, the watchdog that restarts it writes the
+	events of all the recorders, ordered by time, to the file
+	watchdog_<pid>.events in the working directory of the program, before
+	the program is restarted. Up to WD_MAX_RECORDERS recorders may be
+	registered with a handle. Not available with a supervisor.
+RETURN
+	Pointer to the recorder on success.
+	NULL if there are no free recorders or the handle isn't started.
+INPUT
+	wd - pointer to the started handle, NULL for the watchdog started by
+	WDStart or WDStartEx. Only the events of the handle that restarts the
+	program are dumped.
+*/
+wd_recorder_t *WDRegisterRecorder(wd_t *wd);
+
+/*
+DESCRIPTION
+	Records an event with the current CLOCK_MONOTONIC time. Doesn't
+	allocate, lock or make system calls other than clock_gettime, so it
+	may be called from signal handlers. The oldest event of the recorder is
+	overwritten. The meaning of the code and the argument is up to the
+	program.
+RETURN
+	There is no return for this function.
+INPUT
+	recorder - pointer returned by WDRegisterRecorder. Should be used by the
+	thread it was registered by and by its signal handlers.
+	code - code of the event.
+	arg - argument of the event.
+*/
+void WDRecordEvent(wd_recorder_t *recorder, unsigned long code,
+                   unsigned long arg);
+
+/*
+DESCRIPTION
+	Releases the recorder. Its events are still dumped on a crash until
+	another thread registers it.
+RETURN
+	There is no return for this function.
+INPUT
+	recorder - pointer returned by WDRegisterRecorder.
+*/
+void WDUnregisterRecorder(wd_recorder_t *recorder);
+
+/*
+DESCRIPTION
+	Hands a duplicate of a listening socket over to the watchdog of the
+	handle. The watchdog keeps it open and passes it on to the restarted
+	program, so connections queued while the program is down aren't
+	refused. A socket registered again under the same key replaces the
+	previous one. Only the sockets of the handle that restarts the program
+	survive a restart. Not available with a supervisor.
+RETURN
+	0 - on success.
+	1 - the handle isn't started or the socket couldn't be passed.
+INPUT
+	wd - pointer to the started handle, NULL for the watchdog started by
+	WDStart or WDStartEx.
+	key - number of the socket, less than WD_MAX_LISTENERS.
+	fd - the listening socket. Stays owned by the program.
+*/
+int WDRegisterListener(wd_t *wd, size_t key, int fd);
+
+/*
+DESCRIPTION
+	Returns the socket registered under the key. In a restarted program it
+	is the socket of the previous instance, which the program should use
+	instead of creating and binding a new one.
+RETURN
+	The socket on success.
+	-1 if no socket was registered under the key or the handle isn't
+	started.
+INPUT
+	wd - pointer to the started handle, NULL for the watchdog started by
+	WDStart or WDStartEx.
+	key - number of the socket, less than WD_MAX_LISTENERS.
+*/
+int WDGetListener(const wd_t *wd, size_t key);
+
+/*
+DESCRIPTION
+	Parks the hot standby until the watchdog promotes it, see
+	is_hot_standby. Once promoted, the program is watched like a restarted
+	one: it should get its sockets with WDGetListener and its history with
+	WDGetRestartHistory after the function returns. In a program that isn't
+	a standby the function returns at once. A standby is killed if the
+	watchdog exits before promoting it.
+RETURN
+	0 - the program is the one being watched.
+	1 - the promoted standby failed to start its watchdog thread.
+INPUT
+	wd - pointer to the started handle, NULL for the watchdog started by
+	WDStart or WDStartEx.
+*/
+int WDAwaitPromotion(wd_t *wd);
+
+/*
+DESCRIPTION
+	Marks the point the program is initialized at. The function forks a
+	zygote, a frozen copy of the program that does nothing but fork. From
+	then on the program is restarted by forking the zygote, and the new
+	program returns from this function as a restarted one, skipping exec
+	and the initialization. It gets the same memory, sockets and files the
+	program had at the fork point, and only the calling thread. Other
+	threads and anything that doesn't survive fork should be started after
+	the function returns. A program restarted by exec while the zygote is
+	alive returns at once. The zygote exits when the watchdog exits or the
+	program is stopped. Requires pidfd support, only the handle that
+	restarts the program may be passed. Not available with a supervisor.
+RETURN
+	0 - on success, in the program and in every forked program.
+	1 - the zygote couldn't be forked, the program is restarted by exec.
+INPUT
+	wd - pointer to the started handle, NULL for the watchdog started by
+	WDStart or WDStartEx.
+*/
+int WDForkPoint(wd_t *wd);
+
+/*
+DESCRIPTION
+	Reads the statistics of the kicks collected by one side of the handle:
+	by the watchdog process about the program, or by the program about the
+	watchdog process. Not available with a supervisor, and left zero
+	without phi_threshold.
+RETURN
+	0 - on success.
+	1 - the handle isn't started.
+INPUT
+	wd - pointer to the handle, NULL for the watchdog started by WDStart or
+	WDStartEx.
+	is_watchdog - 1 for the statistics of the watchdog process, 0 for the
+	statistics of the program.
+	stats - pointer to the statistics to fill.
+*/
+int WDGetDetectorStats(const wd_t *wd, int is_watchdog,
+                       wd_detector_stats_t *stats);
+
+/*
+DESCRIPTION
+	Returns the state of the peer watched by the handle. In the program the
+	peer is the watchdog.
+RETURN
+	The state of the peer.
+INPUT
+	wd - pointer to the started handle.
+*/
+wd_status_t WDGetStatus(const wd_t *wd);
+
+/*
+DESCRIPTION
+	Runs the supervisor: a single process that watches all the programs
+	registered through the socket, instead of a watchdog process for each
+	of them. Each program costs the supervisor a pidfd and a timer, and a
+	connection for each of its handles; a program with more handles is
+	still watched and restarted once. A program that exits or doesn't kick for its downtime is killed
+	and started again in its working directory with its arguments and the
+	environment of the supervisor. The supervisor itself isn't watched.
+	Runs until SIGTERM or SIGINT is received. The watchdog executable runs
+	it when started as "watchdog.out --supervisor <socket path>".
+RETURN
+	0 - the supervisor was terminated by a signal.
+	1 - on failure to start the supervisor.
+INPUT
+	path - path of the unix socket to listen on. An existing file at the
+	path is replaced.
+*/
+int WDSupervise(const char *path);
+
 #endif /* __NSRD_WATCHDOG_H__ */
@@ -0,0 +1,854 @@
+/*******************************************************************************
+*
+* FILENAME : supervisor.c
+*
+* DESCRIPTION : Implementation of the supervisor. All the programs are
+* watched by one epoll loop: the connections deliver the kicks, pidfds
+* report the exits and a timing wheel keeps the downtime deadlines. Every
+* handle of a program connects on its own, the program itself is watched
+* once and found by its pid.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE /* syscall, struct ucred */
+
+#include <assert.h> /* assert */
+#include <stdlib.h> /* malloc, free */
+#include <string.h> /* memcpy, strlen */
+#include <signal.h> /* sigaction */
+#include <unistd.h> /* close, fork, execvp */
+#include <errno.h> /* errno, EINTR */
+#include <fcntl.h> /* fcntl */
+#include <time.h> /* clock_gettime */
+#include <sys/types.h> /* pid_t */
+#include <sys/socket.h> /* socket */
+#include <sys/un.h> /* sockaddr_un */
+#include <sys/epoll.h> /* epoll */
+#include <sys/syscall.h> /* SYS_pidfd_open */
+
+#include "timing_wheel.h"
+#include "hash_table.h"
+#include "watchdog.h"
+#include "supervisor.h"
+
+#define SV_MAX_EVENTS (64)
+#define SV_MAX_MSG (16384)
+#define SV_MAX_ARGS (256)
+#define MSEC_IN_SEC (1000)
+#define NSEC_IN_MSEC (1000000L)
+
+enum {SV_NEG_FAILURE = -1, SV_SUCCESS, SV_FAILURE};
+enum {FALSE, TRUE};
+enum {SV_EVENT_LISTEN, SV_EVENT_SOCKET, SV_EVENT_PIDFD};
+
+typedef struct sv_conn sv_conn_t;
+typedef struct sv_app sv_app_t;
+
+typedef struct sv_event
+{
+    int kind;
+    sv_conn_t *conn;
+    sv_app_t *app;
+} sv_event_t;
+
+/* a connection of one handle, it refers to its program by the pid, so the
+   program may exit and be freed while the connection is still open */
+struct sv_conn
+{
+    sv_event_t socket_event;
+    int sock;
+    pid_t pid;
+    int is_released;
+    sv_conn_t *prev;
+    sv_conn_t *next;
+};
+
+struct sv_app
+{
+    sv_event_t pidfd_event;
+    int pidfd;
+    pid_t pid;
+    int handles;
+    unsigned long last_kick_ms;
+    int is_released;
+    int argc;
+    size_t downtime_ms;
+    tw_timer_t timer;
+    char *args;
+    sv_app_t *prev;
+    sv_app_t *next;
+};
+
+typedef struct supervisor
+{
+    int epoll_fd;
+    int listen_fd;
+    sv_event_t listen_event;
+    timing_wheel_t *wheel;
+    hash_table_t *pids;
+    struct timespec start;
+    sv_conn_t *conns;
+    sv_app_t *apps;
+    sv_conn_t *released_conns;
+    sv_app_t *released_apps;
+} supervisor_t;
+
+
+static int SvInit(supervisor_t *sv, const char *path);
+static void SvDestroy(supervisor_t *sv, const char *path);
+static int SvWatch(supervisor_t *sv, int fd, sv_event_t *event);
+static void SvAccept(supervisor_t *sv);
+static void SvReceive(supervisor_t *sv, sv_conn_t *conn);
+static int SvRegister(supervisor_t *sv, sv_conn_t *conn, const char *msg,
+                      size_t size);
+static int SvAddApp(supervisor_t *sv, const sv_msg_header_t *header,
+                    const char *args, size_t args_size);
+static void SvUnregister(supervisor_t *sv, sv_conn_t *conn);
+static void SvCheckKicks(supervisor_t *sv);
+static void SvRestart(const sv_app_t *app);
+static void SvReleaseConn(supervisor_t *sv, sv_conn_t *conn);
+static void SvReleaseApp(supervisor_t *sv, sv_app_t *app);
+static void SvFreeConns(sv_conn_t *conn);
+static void SvFreeApps(sv_app_t *app);
+static size_t SvHashPid(const void *pid);
+static int SvIsSamePid(const void *app, void *pid);
+static unsigned long SvNow(const supervisor_t *sv);
+static int SvNextTimeout(const supervisor_t *sv);
+static int SvConnect(const char *path);
+static int SvSendHeader(int sock, sv_msg_type_t type, int flags);
+static void HandleTerm(int sig);
+
+
+static volatile sig_atomic_t g_is_terminated = FALSE;
+
+
+int WDSupervise(const char *path)
+{
+    supervisor_t sv = {0};
+    struct epoll_event events[SV_MAX_EVENTS];
+    struct sigaction act = {0};
+    sigset_t blocked;
+    sigset_t unblocked;
+    int amount = 0;
+    int i = 0;
+
+    assert(NULL != path);
+
+    /* the terminating signals are delivered only while waiting for events */
+    act.sa_handler = HandleTerm;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGTERM);
+    sigaddset(&blocked, SIGINT);
+
+    if (SV_NEG_FAILURE == sigaction(SIGTERM, &act, NULL)
+     || SV_NEG_FAILURE == sigaction(SIGINT, &act, NULL))
+    {
+        return (SV_FAILURE);
+    }
+
+    /* restarted programs are our children, they are reaped by the kernel
+       and their exits are reported by their pidfds anyway */
+    act.sa_handler = SIG_DFL;
+    act.sa_flags = SA_NOCLDWAIT;
+
+    if (SV_NEG_FAILURE == sigaction(SIGCHLD, &act, NULL)
+     || SV_SUCCESS != sigprocmask(SIG_BLOCK, &blocked, &unblocked))
+    {
+        return (SV_FAILURE);
+    }
+
+    sigdelset(&unblocked, SIGTERM);
+    sigdelset(&unblocked, SIGINT);
+
+    if (SvInit(&sv, path))
+    {
+        SvDestroy(&sv, path);
+        return (SV_FAILURE);
+    }
+
+    while (!g_is_terminated)
+    {
+        amount = epoll_pwait(sv.epoll_fd, events, SV_MAX_EVENTS,
+                             SvNextTimeout(&sv), &unblocked);
+
+        for (i = 0; i < amount; ++i)
+        {
+            sv_event_t *event = (sv_event_t *)events[i].data.ptr;
+
+            if (SV_EVENT_LISTEN == event->kind)
+            {
+                SvAccept(&sv);
+            }
+            else if (SV_EVENT_SOCKET == event->kind)
+            {
+                if (!event->conn->is_released)
+                {
+                    SvReceive(&sv, event->conn);
+                }
+            }
+            else if (!event->app->is_released)
+            {
+                SvRestart(event->app);
+                SvReleaseApp(&sv, event->app);
+            }
+        }
+
+        SvCheckKicks(&sv);
+
+        SvFreeConns(sv.released_conns);
+        sv.released_conns = NULL;
+        SvFreeApps(sv.released_apps);
+        sv.released_apps = NULL;
+    }
+
+    SvDestroy(&sv, path);
+
+    return (SV_SUCCESS);
+}
+
+int SupervisorRegister(const char *path, size_t downtime_ms, int argc,
+                       char *argv[])
+{
+    char *msg = NULL;
+    sv_msg_header_t *header = NULL;
+    size_t size = sizeof(sv_msg_header_t);
+    size_t length = 0;
+    int sock = SV_NEG_FAILURE;
+    int i = 0;
+
+    assert(NULL != path);
+    assert(NULL != argv);
+
+    /* every handle registers on its own, maybe from different threads */
+    msg = (char *)malloc(SV_MAX_MSG);
+    if (NULL == msg)
+    {
+        return (SV_NEG_FAILURE);
+    }
+
+    header = (sv_msg_header_t *)msg;
+    header->type = SV_MSG_REGISTER;
+    header->pid = getpid();
+    header->argc = argc;
+    header->downtime_ms = (unsigned long)downtime_ms;
+
+    if (NULL == getcwd(msg + size, SV_MAX_MSG - size))
+    {
+        free(msg);
+        return (SV_NEG_FAILURE);
+    }
+
+    size += strlen(msg + size) + 1;
+
+    for (i = 0; i < argc; ++i)
+    {
+        length = strlen(argv[i]) + 1;
+
+        if (SV_MAX_MSG < size + length)
+        {
+            free(msg);
+            return (SV_NEG_FAILURE);
+        }
+
+        memcpy(msg + size, argv[i], length);
+        size += length;
+    }
+
+    sock = SvConnect(path);
+
+    if (SV_NEG_FAILURE != sock
+     && (SV_NEG_FAILURE == send(sock, msg, size, MSG_NOSIGNAL)
+      || (ssize_t)sizeof(sv_msg_header_t) != recv(sock, msg,
+                                                  sizeof(sv_msg_header_t), 0)
+      || SV_MSG_ACK != header->type))
+    {
+        close(sock);
+        sock = SV_NEG_FAILURE;
+    }
+
+    free(msg);
+
+    return (sock);
+}
+
+int SupervisorKick(int sock)
+{
+    return (SvSendHeader(sock, SV_MSG_KICK, MSG_DONTWAIT));
+}
+
+void SupervisorUnregister(int sock)
+{
+    SvSendHeader(sock, SV_MSG_STOP, 0);
+    close(sock);
+}
+
+static int SvInit(supervisor_t *sv, const char *path)
+{
+    struct sockaddr_un addr = {0};
+
+    sv->epoll_fd = SV_NEG_FAILURE;
+    sv->listen_fd = SV_NEG_FAILURE;
+    sv->conns = NULL;
+    sv->apps = NULL;
+    sv->released_conns = NULL;
+    sv->released_apps = NULL;
+    sv->listen_event.kind = SV_EVENT_LISTEN;
+    sv->listen_event.conn = NULL;
+    sv->listen_event.app = NULL;
+
+    clock_gettime(CLOCK_MONOTONIC, &sv->start);
+
+    if (sizeof(addr.sun_path) <= strlen(path))
+    {
+        return (SV_FAILURE);
+    }
+
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    sv->wheel = TimingWheelCreate();
+    sv->pids = HashTableCreate(SvHashPid, SvIsSamePid, 0);
+    sv->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    sv->listen_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+
+    if (NULL == sv->wheel || NULL == sv->pids
+     || SV_NEG_FAILURE == sv->epoll_fd
+     || SV_NEG_FAILURE == sv->listen_fd)
+    {
+        return (SV_FAILURE);
+    }
+
+    unlink(path);
+
+    if (SV_NEG_FAILURE == bind(sv->listen_fd, (struct sockaddr *)&addr,
+                               sizeof(addr))
+     || SV_NEG_FAILURE == listen(sv->listen_fd, SOMAXCONN))
+    {
+        return (SV_FAILURE);
+    }
+
+    return (SvWatch(sv, sv->listen_fd, &sv->listen_event));
+}
+
+static void SvDestroy(supervisor_t *sv, const char *path)
+{
+    SvFreeConns(sv->conns);
+    SvFreeConns(sv->released_conns);
+    SvFreeApps(sv->apps);
+    SvFreeApps(sv->released_apps);
+
+    if (NULL != sv->pids)
+    {
+        HashTableDestroy(sv->pids);
+        sv->pids = NULL;
+    }
+
+    if (NULL != sv->wheel)
+    {
+        TimingWheelDestroy(sv->wheel);
+        sv->wheel = NULL;
+    }
+
+    if (0 <= sv->listen_fd)
+    {
+        close(sv->listen_fd);
+        unlink(path);
+    }
+
+    if (0 <= sv->epoll_fd)
+    {
+        close(sv->epoll_fd);
+    }
+}
+
+static int SvWatch(supervisor_t *sv, int fd, sv_event_t *event)
+{
+    struct epoll_event ev = {0};
+
+    ev.events = EPOLLIN;
+    ev.data.ptr = event;
+
+    return (SV_SUCCESS != epoll_ctl(sv->epoll_fd, EPOLL_CTL_ADD, fd, &ev));
+}
+
+static void SvAccept(supervisor_t *sv)
+{
+    sv_conn_t *conn = NULL;
+    int sock = accept(sv->listen_fd, NULL, NULL);
+
+    if (SV_NEG_FAILURE == sock)
+    {
+        return;
+    }
+
+    conn = (sv_conn_t *)malloc(sizeof(sv_conn_t));
+    if (NULL == conn
+     || SV_NEG_FAILURE == fcntl(sock, F_SETFD, FD_CLOEXEC))
+    {
+        free(conn);
+        close(sock);
+        return;
+    }
+
+    memset(conn, 0, sizeof(sv_conn_t));
+
+    conn->socket_event.kind = SV_EVENT_SOCKET;
+    conn->socket_event.conn = conn;
+    conn->sock = sock;
+
+    if (SvWatch(sv, sock, &conn->socket_event))
+    {
+        close(sock);
+        free(conn);
+        return;
+    }
+
+    conn->next = sv->conns;
+
+    if (NULL != sv->conns)
+    {
+        sv->conns->prev = conn;
+    }
+
+    sv->conns = conn;
+}
+
+static void SvReceive(supervisor_t *sv, sv_conn_t *conn)
+{
+    static char msg[SV_MAX_MSG];
+    sv_msg_header_t *header = (sv_msg_header_t *)msg;
+    sv_app_t *app = NULL;
+    ssize_t size = recv(conn->sock, msg, SV_MAX_MSG, MSG_DONTWAIT);
+
+    if ((ssize_t)sizeof(sv_msg_header_t) <= size)
+    {
+        switch (header->type)
+        {
+            case SV_MSG_REGISTER:
+                if (0 == conn->pid && SV_SUCCESS == SvRegister(sv, conn, msg,
+                                                              (size_t)size))
+                {
+                    SvSendHeader(conn->sock, SV_MSG_ACK, MSG_DONTWAIT);
+                    return;
+                }
+                break;
+
+            case SV_MSG_KICK:
+                app = (sv_app_t *)HashTableFind(sv->pids, &conn->pid);
+                if (NULL != app)
+                {
+                    app->last_kick_ms = SvNow(sv);
+                }
+                return;
+
+            default:
+                break;
+        }
+
+        SvUnregister(sv, conn);
+        return;
+    }
+
+    if (SV_NEG_FAILURE == size && (EAGAIN == errno || EINTR == errno))
+    {
+        return;
+    }
+
+    /* a lost connection doesn't unregister the program, its exit or its
+       hang is noticed by the pidfd and the timer */
+    SvReleaseConn(sv, conn);
+}
+
+static int SvRegister(supervisor_t *sv, sv_conn_t *conn, const char *msg,
+                      size_t size)
+{
+    const sv_msg_header_t *header = (const sv_msg_header_t *)msg;
+    size_t args_size = size - sizeof(sv_msg_header_t);
+    const char *runner = msg + sizeof(sv_msg_header_t);
+    struct ucred peer = {0};
+    socklen_t peer_size = sizeof(peer);
+    pid_t pid = header->pid;
+    sv_app_t *app = NULL;
+    int strings = 0;
+
+    /* the supervisor kills and runs again whatever it is told, so only
+       a program of its own user may register and only itself */
+    if (SV_NEG_FAILURE == getsockopt(conn->sock, SOL_SOCKET, SO_PEERCRED,
+                                     &peer, &peer_size)
+     || peer.pid != header->pid || peer.uid != getuid())
+    {
+        return (SV_FAILURE);
+    }
+
+    if (0 >= header->pid || 0 >= header->argc || SV_MAX_ARGS <= header->argc
+     || 0 == args_size || '\0' != msg[size - 1])
+    {
+        return (SV_FAILURE);
+    }
+
+    /* the cwd and exactly argc arguments, SvRestart walks them blindly */
+    for (; runner < msg + size; runner += strlen(runner) + 1)
+    {
+        ++strings;
+    }
+
+    if (1 + header->argc != strings)
+    {
+        return (SV_FAILURE);
+    }
+
+    /* more handles of a program share its entry, so a crash restarts it
+       once and a hang kills it once; the first registration tells how */
+    app = (sv_app_t *)HashTableFind(sv->pids, &pid);
+    if (NULL == app && SvAddApp(sv, header, msg + sizeof(sv_msg_header_t),
+                                args_size))
+    {
+        return (SV_FAILURE);
+    }
+
+    if (NULL != app)
+    {
+        ++app->handles;
+    }
+
+    conn->pid = pid;
+
+    return (SV_SUCCESS);
+}
+
+static int SvAddApp(supervisor_t *sv, const sv_msg_header_t *header,
+                    const char *args, size_t args_size)
+{
+    sv_app_t *app = (sv_app_t *)malloc(sizeof(sv_app_t));
+
+    if (NULL == app)
+    {
+        return (SV_FAILURE);
+    }
+
+    memset(app, 0, sizeof(sv_app_t));
+
+    app->pidfd_event.kind = SV_EVENT_PIDFD;
+    app->pidfd_event.app = app;
+    app->pidfd = SV_NEG_FAILURE;
+    app->pid = header->pid;
+    app->handles = 1;
+    app->argc = header->argc;
+    app->downtime_ms = (size_t)header->downtime_ms;
+
+    app->next = sv->apps;
+
+    if (NULL != sv->apps)
+    {
+        sv->apps->prev = app;
+    }
+
+    sv->apps = app;
+
+    if (SV_SUCCESS != HashTableInsert(sv->pids, &app->pid, app))
+    {
+        /* not in the table yet, so it can't be removed from it */
+        app->pid = 0;
+        SvReleaseApp(sv, app);
+
+        return (SV_FAILURE);
+    }
+
+    app->args = (char *)malloc(args_size);
+    if (NULL == app->args)
+    {
+        SvReleaseApp(sv, app);
+
+        return (SV_FAILURE);
+    }
+
+    memcpy(app->args, args, args_size);
+
+#ifdef SYS_pidfd_open
+    app->pidfd = (int)syscall(SYS_pidfd_open, app->pid, 0);
+#endif
+
+    if (0 > app->pidfd || SvWatch(sv, app->pidfd, &app->pidfd_event))
+    {
+        SvReleaseApp(sv, app);
+
+        return (SV_FAILURE);
+    }
+
+    /* the registration counts as the first kick */
+    app->last_kick_ms = SvNow(sv);
+    app->timer = TimingWheelAdd(sv->wheel, app,
+                                app->last_kick_ms + app->downtime_ms);
+    if (NULL == app->timer)
+    {
+        SvReleaseApp(sv, app);
+
+        return (SV_FAILURE);
+    }
+
+    return (SV_SUCCESS);
+}
+
+/* the program is watched until every handle that registered it stops */
+static void SvUnregister(supervisor_t *sv, sv_conn_t *conn)
+{
+    sv_app_t *app = (sv_app_t *)HashTableFind(sv->pids, &conn->pid);
+
+    if (NULL != app && 0 == --app->handles)
+    {
+        SvReleaseApp(sv, app);
+    }
+
+    SvReleaseConn(sv, conn);
+}
+
+/* the timer of a program expires a downtime after its last kick, kicks
+   in between only move the deadline, which is checked when it's reached */
+static void SvCheckKicks(supervisor_t *sv)
+{
+    unsigned long now = SvNow(sv);
+    sv_app_t *app = NULL;
+
+    TimingWheelAdvance(sv->wheel, now);
+
+    while (NULL != (app = (sv_app_t *)TimingWheelPopExpired(sv->wheel)))
+    {
+        app->timer = NULL;
+
+        if (now - app->last_kick_ms >= app->downtime_ms)
+        {
+            /* the pidfd reports the exit and the program is restarted */
+            kill(app->pid, SIGKILL);
+            continue;
+        }
+
+        app->timer = TimingWheelAdd(sv->wheel, app,
+                                    app->last_kick_ms + app->downtime_ms);
+    }
+}
+
+/* the program registers itself again when it calls WDStartHandle */
+static void SvRestart(const sv_app_t *app)
+{
+    char *argv[SV_MAX_ARGS + 1];
+    char *runner = app->args + strlen(app->args) + 1;
+    pid_t pid = 0;
+    int i = 0;
+
+    for (i = 0; i < app->argc; ++i)
+    {
+        argv[i] = runner;
+        runner += strlen(runner) + 1;
+    }
+
+    argv[app->argc] = NULL;
+
+    pid = fork();
+    if (0 == pid)
+    {
+        sigset_t all;
+
+        sigemptyset(&all);
+        sigprocmask(SIG_SETMASK, &all, NULL);
+
+        if (SV_SUCCESS == chdir(app->args))
+        {
+            execvp(argv[0], argv);
+        }
+
+        _exit(SV_FAILURE);
+    }
+}
+
+/* events of the same epoll batch may still point to the connection, so it
+   is freed after the batch */
+static void SvReleaseConn(supervisor_t *sv, sv_conn_t *conn)
+{
+    if (0 <= conn->sock)
+    {
+        close(conn->sock);
+        conn->sock = SV_NEG_FAILURE;
+    }
+
+    if (NULL != conn->prev)
+    {
+        conn->prev->next = conn->next;
+    }
+    else
+    {
+        sv->conns = conn->next;
+    }
+
+    if (NULL != conn->next)
+    {
+        conn->next->prev = conn->prev;
+    }
+
+    conn->is_released = TRUE;
+    conn->prev = NULL;
+    conn->next = sv->released_conns;
+    sv->released_conns = conn;
+}
+
+/* like the connections, the program is freed after the batch */
+static void SvReleaseApp(supervisor_t *sv, sv_app_t *app)
+{
+    if (NULL != app->timer)
+    {
+        TimingWheelRemove(sv->wheel, app->timer);
+        app->timer = NULL;
+    }
+
+    if (0 <= app->pidfd)
+    {
+        close(app->pidfd);
+        app->pidfd = SV_NEG_FAILURE;
+    }
+
+    if (0 != app->pid)
+    {
+        HashTableRemove(sv->pids, &app->pid);
+    }
+
+    if (NULL != app->prev)
+    {
+        app->prev->next = app->next;
+    }
+    else
+    {
+        sv->apps = app->next;
+    }
+
+    if (NULL != app->next)
+    {
+        app->next->prev = app->prev;
+    }
+
+    app->is_released = TRUE;
+    app->prev = NULL;
+    app->next = sv->released_apps;
+    sv->released_apps = app;
+}
+
+static void SvFreeConns(sv_conn_t *conn)
+{
+    while (NULL != conn)
+    {
+        sv_conn_t *next = conn->next;
+
+        if (0 <= conn->sock)
+        {
+            close(conn->sock);
+        }
+
+        free(conn);
+
+        conn = next;
+    }
+}
+
+static void SvFreeApps(sv_app_t *app)
+{
+    while (NULL != app)
+    {
+        sv_app_t *next = app->next;
+
+        if (0 <= app->pidfd)
+        {
+            close(app->pidfd);
+        }
+
+        free(app->args);
+        free(app);
+
+        app = next;
+    }
+}
+
+static unsigned long SvNow(const supervisor_t *sv)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((unsigned long)(now.tv_sec - sv->start.tv_sec) * MSEC_IN_SEC
+          + (unsigned long)((now.tv_nsec - sv->start.tv_nsec) / NSEC_IN_MSEC));
+}
+
+static int SvNextTimeout(const supervisor_t *sv)
+{
+    unsigned long now = 0;
+    unsigned long next = 0;
+
+    if (TimingWheelIsEmpty(sv->wheel))
+    {
+        return (SV_NEG_FAILURE);
+    }
+
+    now = SvNow(sv);
+    next = TimingWheelNextTick(sv->wheel);
+
+    return (next <= now ? 0 : (int)(next - now));
+}
+
+static int SvConnect(const char *path)
+{
+    struct sockaddr_un addr = {0};
+    int sock = 0;
+
+    if (sizeof(addr.sun_path) <= strlen(path))
+    {
+        return (SV_NEG_FAILURE);
+    }
+
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (SV_NEG_FAILURE == sock)
+    {
+        return (SV_NEG_FAILURE);
+    }
+
+    if (SV_NEG_FAILURE == connect(sock, (struct sockaddr *)&addr,
+                                  sizeof(addr)))
+    {
+        close(sock);
+        return (SV_NEG_FAILURE);
+    }
+
+    return (sock);
+}
+
+static int SvSendHeader(int sock, sv_msg_type_t type, int flags)
+{
+    sv_msg_header_t header = {0};
+
+    header.type = type;
+    header.pid = getpid();
+
+    return (SV_NEG_FAILURE == send(sock, &header, sizeof(header),
+                                   flags | MSG_NOSIGNAL));
+}
+
+static size_t SvHashPid(const void *pid)
+{
+    return ((size_t)*(const pid_t *)pid);
+}
+
+static int SvIsSamePid(const void *app, void *pid)
+{
+    return (((const sv_app_t *)app)->pid == *(pid_t *)pid);
+}
+
+static void HandleTerm(int sig)
+{
+    g_is_terminated = TRUE;
+
+    (void) sig;
+}
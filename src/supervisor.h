@@ -0,0 +1,87 @@
+/*******************************************************************************
+*
+* FILENAME : supervisor.h
+*
+* DESCRIPTION : Protocol between the programs and the supervisor, a single
+* process that watches many programs. A program connects to the unix socket
+* of the supervisor, registers itself with the arguments to restart it with,
+* and kicks the supervisor over the connection. The supervisor restarts a
+* program that exits or stops kicking for the downtime.
+*
+* AUTHOR : Nick Shenderov
+*
+* DATE : 16.10.2026
+*
+*******************************************************************************/
+
+#ifndef __NSRD_SUPERVISOR_H__
+#define __NSRD_SUPERVISOR_H__
+
+#include <stddef.h> /* size_t */
+#include <sys/types.h> /* pid_t */
+
+typedef enum sv_msg_type
+{
+    SV_MSG_REGISTER,
+    SV_MSG_KICK,
+    SV_MSG_STOP,
+    SV_MSG_ACK
+} sv_msg_type_t;
+
+/*
+DESCRIPTION
+    Header of every message. A registration message is followed by the
+    working directory of the program and its arguments, each terminated by
+    '\0'. The other messages consist of the header only.
+*/
+typedef struct sv_msg_header
+{
+    sv_msg_type_t type;
+    pid_t pid;
+    int argc;
+    unsigned long downtime_ms;
+} sv_msg_header_t;
+
+/*
+DESCRIPTION
+    Connects to the supervisor and registers the calling process. Waits
+    until the supervisor confirms the registration. Every handle of a
+    process may register on its own connection; the process is watched
+    and restarted once, with the arguments and the downtime of its first
+    registration.
+RETURN
+    Socket of the connection on success.
+    -1 on failure.
+INPUT
+    path - path of the socket of the supervisor.
+    downtime_ms - the time interval in milliseconds for which the program
+    is allowed to not kick.
+    argc - number of the arguments to restart the program with.
+    argv - the arguments to restart the program with.
+*/
+int SupervisorRegister(const char *path, size_t downtime_ms, int argc,
+                       char *argv[]);
+
+/*
+DESCRIPTION
+    Kicks the supervisor. Doesn't block.
+RETURN
+    0 - on success.
+    1 - the supervisor can't be reached.
+INPUT
+    sock - socket returned by SupervisorRegister.
+*/
+int SupervisorKick(int sock);
+
+/*
+DESCRIPTION
+    Closes the registration and the socket. The supervisor stops watching
+    the program once all its registrations are closed.
+RETURN
+    There is no return for this function.
+INPUT
+    sock - socket returned by SupervisorRegister.
+*/
+void SupervisorUnregister(int sock);
+
+#endif /* __NSRD_SUPERVISOR_H__ */
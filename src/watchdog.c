@@ -11,406 +11,3173 @@
 *******************************************************************************/
 
 #define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE /* syscall */
 
 #include <assert.h> /* assert */
-#include <stdio.h> /* sprintf */
-#include <stdlib.h> /* exit */
+#include <stdio.h> /* sprintf, fopen */
+#include <stdlib.h> /* exit, qsort */
+#include <string.h> /* memcpy */
+#include <math.h> /* exp, log10, sqrt */
 #include <signal.h> /* signal */
-#include <semaphore.h> /* semaphores */
-#include <fcntl.h> /* O_CREAT */
+#include <limits.h> /* INT_MAX */
+#include <fcntl.h> /* fcntl */
 #include <pthread.h> /* threads */
-#include <unistd.h> /* getpgid */
+#include <sched.h> /* sched_yield */
+#include <unistd.h> /* getppid */
+#include <time.h> /* nanosleep */
+#include <errno.h> /* errno, ECHILD */
 #include <sys/types.h> /* pid_t */
-#include <sys/shm.h> /* key_t, ftok */
+#include <sys/stat.h> /* fstat */
+#include <sys/socket.h> /* socketpair, sendmsg, recvmsg */
+#include <sys/mman.h> /* mmap */
+#include <sys/wait.h> /* waitpid */
+#include <sys/prctl.h> /* prctl */
+#include <sys/syscall.h> /* SYS_pidfd_open, SYS_futex, SYS_memfd_create */
+#include <linux/futex.h> /* FUTEX_WAIT, FUTEX_WAKE */
+#include <linux/memfd.h> /* MFD_CLOEXEC */
+#include <poll.h> /* poll */
+#include <spawn.h> /* posix_spawnp */
 
 #include "scheduler.h"
 #include "watchdog.h"
+#include "supervisor.h"
 
 #define MAX_ARGS_AMOUNT (256)
 #define CLOSE_ATTEMPTS_AMOUNT (5)
 #define KICKTIME_FREQUENCY (5)
+#define WD_ARGS_OFFSET (14)
+#define MSEC_IN_SEC (1000)
+#define NSEC_IN_MSEC (1000000L)
+#define NSEC_IN_SEC (1000000000UL)
+#define EXIT_CHECK_MS (10)
+#define ARG_STR_SIZE (24)
+#define WD_RESTARTER_ID (0)
+#define WD_OPTION_ARGS (WD_ARGS_OFFSET - 1)
+#define DEFAULT_RESTART_WINDOW_MS (60000)
+#define DEFAULT_BACKOFF_MAX_MS (30000)
+#define CACHE_LINE_SIZE (64)
+#define PHI_WINDOW (100)
+#define PHI_MIN_SAMPLES (8)
+#define PHI_MIN_STDDEV_DIVISOR (4)
+#define PHI_SCALE (1000)
+#define PHI_LINEAR_Z (30.0)
+#define WD_SHARED_FD_ARG (WD_ARGS_OFFSET - 2)
+#define SHARED_FD_ENV ("WD_SHARED_FD_")
+#define STANDBY_ENV ("WD_STANDBY_")
+#define SHARED_NAME ("watchdog")
+#define SHARED_MAGIC (0x57444f47UL)
+#define INHERITED_FDS_AMOUNT (WD_MAX_LISTENERS + 4)
+#define CHECKPOINT_KEY (WD_MAX_LISTENERS)
+#define CHECKPOINT_NAME ("watchdog_checkpoint")
+#define RECORDER_FILE ("watchdog_%d.events")
+#define RECORDER_FILE_SIZE (32)
 
 enum {WD_NEG_FAILURE = -1, WD_SUCCESS, WD_FAILURE};
 enum {WD_COMPLETE, WD_RESCHEDULE};
 enum {FALSE, TRUE};
-typedef struct wdparams
+enum {WD_SIDE_APP, WD_SIDE_WD, WD_SIDES_AMOUNT};
+enum {WD_SLOT_FREE, WD_SLOT_CLAIMED, WD_SLOT_ACTIVE};
+
+typedef struct wd_beat
+{
+    volatile unsigned long seq;
+    struct timespec kick_time;
+    volatile unsigned long progress;
+} wd_beat_t;
+
+typedef struct wd_history
+{
+    volatile unsigned long count;
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+} wd_history_t;
+
+struct wd_thread
+{
+    volatile unsigned long seq;
+    volatile int state;
+    volatile int is_late;
+    int is_report_only;
+    unsigned long deadline_ms;
+};
+
+/* each thread kicks its own cache line, so the kicks don't contend */
+typedef union wd_thread_slot
+{
+    struct wd_thread thread;
+    char padding[CACHE_LINE_SIZE];
+} wd_thread_slot_t;
+
+/* the seq is the index of the event plus one once it is written */
+typedef struct wd_event
+{
+    volatile unsigned long seq;
+    unsigned long time_ns;
+    unsigned long code;
+    unsigned long arg;
+} wd_event_t;
+
+struct wd_recorder
+{
+    wd_event_t events[WD_RECORDER_EVENTS];
+    volatile unsigned long head;
+    volatile int state;
+};
+
+typedef struct wd_dumped_event
+{
+    unsigned long time_ns;
+    size_t recorder;
+    unsigned long code;
+    unsigned long arg;
+} wd_dumped_event_t;
+
+/* the seq is odd while the stats are written */
+typedef struct wd_stats_slot
+{
+    volatile unsigned long seq;
+    wd_detector_stats_t stats;
+} wd_stats_slot_t;
+
+/* the page is aligned, so are the slots at its start */
+typedef struct wd_shared
+{
+    wd_thread_slot_t threads[WD_MAX_THREADS];
+    struct wd_recorder recorders[WD_MAX_RECORDERS];
+    wd_beat_t beats[WD_SIDES_AMOUNT];
+    wd_stats_slot_t detectors[WD_SIDES_AMOUNT];
+    volatile int is_ready[WD_SIDES_AMOUNT];
+    volatile int is_stop_acked;
+    volatile int is_standby_parked;
+    volatile int is_standby_promoted;
+    volatile pid_t zygote_pid;
+    volatile pid_t watchdog_pid;
+    volatile pid_t forked_pid;
+    volatile int is_fork_requested;
+    volatile int is_forked;
+    int listener_socks[WD_SIDES_AMOUNT];
+    int listeners[WD_MAX_LISTENERS];
+    int checkpoint_fd;
+    unsigned long magic;
+    wd_history_t history[WD_SIDES_AMOUNT];
+} wd_shared_t;
+
+typedef struct wd_detector
+{
+    pid_t pid;
+    int is_first;
+    unsigned long arrivals;
+    unsigned long last_ms;
+    unsigned long intervals[PHI_WINDOW];
+    size_t next;
+    size_t samples;
+    double mean_ms;
+    double stddev_ms;
+    double max_phi;
+} wd_detector_t;
+
+struct wd
+{
+    int wd_sig_is_received;
+    int wd_sig_stop_is_received;
+    int is_wd;
+    size_t slot;
+    unsigned long id;
+    int wd_argc;
+    size_t kicktime_ms;
+    size_t downtime_ms;
+    wd_heartbeat_t heartbeat;
+    wd_spawn_t spawn;
+    size_t max_restarts;
+    size_t restart_window_ms;
+    size_t backoff_min_ms;
+    size_t backoff_max_ms;
+    void (*on_give_up)(void *param);
+    void *give_up_param;
+    void (*on_ready)(int status, void *param);
+    void *ready_param;
+    int is_app_kicked;
+    volatile unsigned long app_kicks;
+    unsigned long forwarded_kicks;
+    double phi_threshold;
+    volatile unsigned long peer_kicks;
+    volatile unsigned long peer_kick_ms;
+    wd_detector_t detector;
+    size_t progress_window_ms;
+    int is_hot_standby;
+    int is_standby;
+    pid_t standby_pid;
+    volatile unsigned long progress;
+    volatile unsigned long peer_progress;
+    unsigned long checked_progress;
+    unsigned long progress_ms;
+    pid_t progress_pid;
+    int is_peer_stalled;
+    int is_restart_pending;
+    int is_given_up;
+    unsigned int jitter_seed;
+    size_t restarts_amount;
+    unsigned long restart_times[WD_HISTORY_SIZE];
+    wd_restart_record_t pending_record;
+    int is_thread_tracked[WD_MAX_THREADS];
+    unsigned long thread_seqs[WD_MAX_THREADS];
+    unsigned long thread_kick_ms[WD_MAX_THREADS];
+    unsigned long peer_seq;
+    int is_peer_restarted;
+    int peer_pidfd;
+    int is_peer_reaped;
+    int peer_status;
+    wd_shared_t *shared;
+    pthread_t id_thread;
+    pid_t observed_pid;
+    scheduler_t *scheduler;
+    int shared_fd;
+    int listeners[WD_MAX_LISTENERS];
+    int checkpoint_fd;
+    void *checkpoint;
+    size_t checkpoint_size;
+    int supervisor_fd;
+    char supervisor_path[MAX_ARGS_AMOUNT];
+    char option_strs[WD_OPTION_ARGS][ARG_STR_SIZE];
+    char *wd_argv[MAX_ARGS_AMOUNT];
+};
+
+
+static int WDInitSharedMemory(wd_t *wd);
+static int WDTakeInheritedFd(const wd_t *wd);
+static int WDCreateShared(void);
+static wd_shared_t *WDMapShared(int fd);
+static int WDExportSharedFd(const wd_t *wd);
+static int WDInitListeners(wd_shared_t *shared);
+static void WDCloseOnExec(const wd_t *wd);
+static size_t WDInheritedFds(const wd_t *wd, int *fds);
+static int TaskReceiveListeners(void *argv);
+static void WDReceiveListeners(wd_t *wd);
+static int WDSendFd(int sock, size_t key, int fd);
+static int WDRecvFd(int sock, size_t *key, int *fd);
+static int WDIsPeerAlive(wd_t *wd);
+static void WDBeat(wd_t *wd);
+static void WDWatchPeer(wd_t *wd);
+static int WDIsPeerExited(wd_t *wd);
+static pid_t WDReapPeer(wd_t *wd, int options);
+static void WDSpawnPeer(wd_t *wd);
+static pid_t WDExecPeer(wd_t *wd);
+static void WDLosePeer(wd_t *wd, int is_hang);
+static void WDRestartPeer(wd_t *wd, int is_hang);
+static void WDReplacePeer(wd_t *wd);
+static int WDPromoteStandby(wd_t *wd);
+static void WDSpawnStandby(wd_t *wd);
+static void WDKillStandby(wd_t *wd);
+static int WDTakeStandby(const wd_t *wd);
+static int TaskWatchStandby(void *argv);
+static int WDForkFromZygote(wd_t *wd);
+static int WDRunZygote(wd_t *wd);
+static int WDIsZygoteAlive(const wd_shared_t *shared);
+static void WDKillZygote(wd_t *wd);
+static int WDStartAdopted(wd_t *wd);
+static void WDGiveUp(wd_t *wd);
+static size_t WDCountRecentRestarts(wd_t *wd, unsigned long now_ms);
+static size_t WDBackoffMs(wd_t *wd, size_t recent_restarts);
+static unsigned long WDNowMs(void);
+static int TaskRestart(void *argv);
+static int WDIsPeerWatched(const wd_t *wd);
+static int TaskScanThreads(void *argv);
+static void WDClearThreads(wd_t *wd);
+static void WDClearRecorders(wd_t *wd);
+static void WDDumpRecorders(wd_t *wd, const wd_restart_record_t *record);
+static int CompareEventTime(const void *event1, const void *event2);
+static int TaskDetect(void *argv);
+static int TaskCheckProgress(void *argv);
+static unsigned long WDPeerProgress(const wd_t *wd);
+static unsigned long WDPeerArrivals(const wd_t *wd, unsigned long *last_ms);
+static void WDAddInterval(wd_detector_t *detector, unsigned long interval_ms);
+static double WDPhi(const wd_detector_t *detector, unsigned long elapsed_ms);
+static void WDPublishStats(wd_t *wd, double phi);
+static unsigned long WDToMs(const struct timespec *time);
+static void WDRecordRestart(wd_t *wd, const wd_restart_record_t *record);
+static int CompareRestartTime(const wd_restart_record_t *record1,
+                              const wd_restart_record_t *record2);
+static int TaskWatchExit(void *argv);
+static void WDGraceExit(wd_t *wd);
+static void WDRunnerExit(void);
+static int WDInitSigHandlers(void);
+static void *WDThread(void *argv);
+static void *WDKickThread(void *argv);
+static int WDStartSupervised(wd_t *wd, int argc, char *argv[]);
+static int WDInitScheduler(wd_t *wd);
+static int WDInitHandle(wd_t *wd, int argc, char *argv[]);
+static int WDRunWatchdog(wd_t *wd, int argc, char *argv[]);
+static void WDInitParameters(wd_t *wd, int argc, char *argv[]);
+static int WDSetAppParams(wd_t *wd);
+static void WDSetWdParams(wd_t *wd);
+static int WDSyncPeer(wd_t *wd);
+static int WDSyncApp(wd_t *wd);
+static void WDRaiseFlag(volatile int *flag);
+static int WDWaitFlag(volatile int *flag, size_t timeout_ms);
+static int WDWaitStopAck(wd_t *wd, size_t timeout_ms);
+static void HandleKick(int sig, siginfo_t *info, void *context);
+static void HandleStop(int sig, siginfo_t *info, void *context);
+static int TaskKick(void *operation_params);
+static void TaskCleanupDummy(void *cleanup_params);
+static int TaskReboot(void *argv);
+
+
+const int __attribute__((weak)) g_is_wd;
+extern char **environ;
+
+/* signal handlers find the handle the signal is meant for by the sender */
+static wd_t *g_handles[WD_MAX_HANDLES];
+/* signal handlers in progress on any thread, see WDDestroy */
+static int g_handlers_running = 0;
+static wd_t *g_default_wd = NULL;
+static wd_t *g_runner_wd = NULL;
+
+
+int WDStart(int argc, char *argv[], size_t downtime)
+{
+    wd_options_t options = {0};
+
+    assert(5 <= downtime);
+
+    options.downtime_ms = downtime * MSEC_IN_SEC;
+
+    return (WDStartEx(argc, argv, &options));
+}
+
+int WDStartEx(int argc, char *argv[], const wd_options_t *options)
+{
+    assert(NULL == g_default_wd);
+
+    g_default_wd = WDCreate(options);
+    if (NULL == g_default_wd)
+    {
+        return (WD_FAILURE);
+    }
+
+    if (WDStartHandle(g_default_wd, argc, argv))
+    {
+        WDDestroy(g_default_wd);
+        g_default_wd = NULL;
+
+        return (WD_FAILURE);
+    }
+
+    return (WD_SUCCESS);
+}
+
+int WDStartAsync(int argc, char *argv[], const wd_options_t *options,
+                 void (*on_ready)(int status, void *param), void *param)
+{
+    assert(NULL == g_default_wd);
+
+    g_default_wd = WDCreate(options);
+    if (NULL == g_default_wd)
+    {
+        return (WD_FAILURE);
+    }
+
+    if (WDStartHandleAsync(g_default_wd, argc, argv, on_ready, param))
+    {
+        WDDestroy(g_default_wd);
+        g_default_wd = NULL;
+
+        return (WD_FAILURE);
+    }
+
+    return (WD_SUCCESS);
+}
+
+void WDStop(void)
+{
+    assert(NULL != g_default_wd);
+
+    WDStopEx(CLOSE_ATTEMPTS_AMOUNT * g_default_wd->downtime_ms);
+}
+
+int WDStopEx(size_t timeout_ms)
+{
+    int status = WD_SUCCESS;
+
+    assert(NULL != g_default_wd);
+
+    status = WDStopHandle(g_default_wd, timeout_ms);
+
+    WDDestroy(g_default_wd);
+    g_default_wd = NULL;
+
+    return (status);
+}
+
+size_t WDGetRestartHistory(wd_restart_record_t *records, size_t max_records)
+{
+    if (NULL == g_default_wd)
+    {
+        return (0);
+    }
+
+    return (WDGetRestartHistoryHandle(g_default_wd, records, max_records));
+}
+
+wd_t *WDCreate(const wd_options_t *options)
+{
+    wd_t *wd = NULL;
+    size_t slot = 0;
+
+    assert(NULL != options);
+    assert(WD_MIN_DOWNTIME_MS <= options->downtime_ms);
+    assert(options->kicktime_ms < options->downtime_ms);
+
+    wd = (wd_t *)malloc(sizeof(wd_t));
+    if (NULL == wd)
+    {
+        return (NULL);
+    }
+
+    memset(wd, 0, sizeof(wd_t));
+
+    wd->downtime_ms = options->downtime_ms;
+    wd->kicktime_ms = options->kicktime_ms;
+    wd->heartbeat = options->heartbeat;
+    wd->spawn = options->spawn;
+    wd->max_restarts = options->max_restarts;
+    wd->restart_window_ms = options->restart_window_ms;
+    wd->backoff_min_ms = options->backoff_min_ms;
+    wd->backoff_max_ms = options->backoff_max_ms;
+    wd->on_give_up = options->on_give_up;
+    wd->give_up_param = options->give_up_param;
+    wd->is_app_kicked = options->is_app_kicked;
+    wd->phi_threshold = options->phi_threshold;
+    wd->progress_window_ms = options->progress_window_ms;
+    wd->is_hot_standby = options->is_hot_standby;
+    wd->is_wd = g_is_wd;
+    wd->peer_pidfd = WD_NEG_FAILURE;
+    wd->supervisor_fd = WD_NEG_FAILURE;
+    wd->shared_fd = WD_NEG_FAILURE;
+    wd->checkpoint_fd = WD_NEG_FAILURE;
+
+    if (NULL != options->supervisor)
+    {
+        assert(strlen(options->supervisor) < MAX_ARGS_AMOUNT);
+
+        strcpy(wd->supervisor_path, options->supervisor);
+    }
+
+    if (0 == wd->kicktime_ms)
+    {
+        wd->kicktime_ms = options->downtime_ms / KICKTIME_FREQUENCY;
+    }
+
+    if (0 == wd->restart_window_ms)
+    {
+        wd->restart_window_ms = DEFAULT_RESTART_WINDOW_MS;
+    }
+
+    if (0 == wd->backoff_max_ms)
+    {
+        wd->backoff_max_ms = DEFAULT_BACKOFF_MAX_MS;
+    }
+
+    assert(0.0 <= wd->phi_threshold);
+
+    /* the limit is checked against the history, it can't count further */
+    if (WD_HISTORY_SIZE < wd->max_restarts)
+    {
+        free(wd);
+        return (NULL);
+    }
+
+    /* the lowest free slot, so the handle created after the restarter is
+       destroyed takes its slot and becomes the restarter */
+    for (slot = 0; slot < WD_MAX_HANDLES; ++slot)
+    {
+        if (__sync_bool_compare_and_swap(&g_handles[slot], NULL, wd))
+        {
+            wd->slot = slot;
+            wd->id = (unsigned long)slot;
+
+            return (wd);
+        }
+    }
+
+    free(wd);
+
+    return (NULL);
+}
+
+void WDDestroy(wd_t *wd)
+{
+    if (NULL == wd)
+    {
+        return;
+    }
+
+    __sync_bool_compare_and_swap(&g_handles[wd->slot], wd, NULL);
+
+    /* a handler on another thread may have loaded the handle just before
+       the slot was cleared; the handlers count themselves before loading,
+       so once none runs no one can write to the handle */
+    while (0 != __sync_fetch_and_add(&g_handlers_running, 0))
+    {
+        sched_yield();
+    }
+
+    free(wd);
+    wd = NULL;
+}
+
+int WDStartHandle(wd_t *wd, int argc, char *argv[])
+{
+    assert(NULL != wd);
+    assert(NULL != argv[0]);
+    assert(0 < argc);
+
+    if (wd->is_wd)
+    {
+        return (WDRunWatchdog(wd, argc, argv));
+    }
+
+    if (WDStartHandleAsync(wd, argc, argv, NULL, NULL))
+    {
+        return (WD_FAILURE);
+    }
+
+    /* the program is watched from the moment the function returns, a
+       standby from the moment it is promoted */
+    if (NULL != wd->shared && !wd->is_standby)
+    {
+        WDSyncApp(wd);
+    }
+
+    return (WD_SUCCESS);
+}
+
+int WDStartHandleAsync(wd_t *wd, int argc, char *argv[],
+                       void (*on_ready)(int status, void *param), void *param)
+{
+    assert(NULL != wd);
+    assert(NULL != argv[0]);
+    assert(0 < argc);
+    assert(!wd->is_wd);
+
+    wd->on_ready = on_ready;
+    wd->ready_param = param;
+
+    if ('\0' != wd->supervisor_path[0])
+    {
+        return (WDStartSupervised(wd, argc, argv));
+    }
+
+    if (WDInitHandle(wd, argc, argv) || WDSetAppParams(wd))
+    {
+        return (WD_FAILURE);
+    }
+
+    /* see WDAwaitPromotion */
+    if (wd->is_standby)
+    {
+        return (WD_SUCCESS);
+    }
+
+    /* the watchdog that restarted the program waits for it */
+    if (0 != wd->observed_pid)
+    {
+        WDRaiseFlag(&wd->shared->is_ready[WD_SIDE_APP]);
+    }
+
+    if (WD_SUCCESS != pthread_create(&wd->id_thread, NULL, WDThread, wd))
+    {
+        return (WD_FAILURE);
+    }
+
+    return (WD_SUCCESS);
+}
+
+int WDStopHandle(wd_t *wd, size_t timeout_ms)
+{
+    int status = WD_SUCCESS;
+
+    assert(NULL != wd);
+
+    /* keeps the own tasks from restarting the watchdog while it exits */
+    wd->wd_sig_stop_is_received = TRUE;
+    SchedulerStop(wd->scheduler);
+
+    /* a standby that wasn't promoted has no thread and watches no one */
+    if (wd->is_standby)
+    {
+        WDGraceExit(wd);
+
+        return (WD_SUCCESS);
+    }
+
+    pthread_join(wd->id_thread, NULL);
+
+    if (0 <= wd->supervisor_fd)
+    {
+        SupervisorUnregister(wd->supervisor_fd);
+        wd->supervisor_fd = WD_NEG_FAILURE;
+
+        SchedulerClear(wd->scheduler);
+        SchedulerDestroy(wd->scheduler);
+
+        return (WD_SUCCESS);
+    }
+
+    wd->shared->is_stop_acked = FALSE;
+
+    /* the handle may be stopped before its watchdog was spawned, or after
+       the watchdog has exited */
+    if (0 < wd->observed_pid && !wd->is_restart_pending && !wd->is_given_up)
+    {
+        kill(wd->observed_pid, SIGUSR2);
+
+        if (WD_SUCCESS != WDWaitStopAck(wd, timeout_ms))
+        {
+            kill(wd->observed_pid, SIGKILL);
+            status = WD_FAILURE;
+        }
+    }
+
+    WDKillZygote(wd);
+    WDGraceExit(wd);
+
+    /* the watchdog exits right after it acknowledges the stop */
+    WDReapPeer(wd, 0);
+
+    return (status);
+}
+
+size_t WDGetRestartHistoryHandle(const wd_t *wd, wd_restart_record_t *records,
+                                 size_t max_records)
+{
+    wd_restart_record_t all[WD_SIDES_AMOUNT * WD_HISTORY_SIZE];
+    size_t amount = 0;
+    size_t i = 0;
+    int side = 0;
+
+    assert(NULL != wd);
+    assert(NULL != records || 0 == max_records);
+
+    if (NULL == wd->shared)
+    {
+        return (0);
+    }
+
+    for (side = 0; side < WD_SIDES_AMOUNT; ++side)
+    {
+        wd_history_t *history = &wd->shared->history[side];
+        unsigned long count = history->count;
+        unsigned long first = 0;
+
+        __sync_synchronize();
+
+        first = (WD_HISTORY_SIZE < count) ? count - WD_HISTORY_SIZE : 0;
+
+        for (; first < count; ++first)
+        {
+            all[amount] = history->records[first % WD_HISTORY_SIZE];
+            ++amount;
+        }
+    }
+
+    /* insertion sort, the records of each side are already in order */
+    for (i = 1; i < amount; ++i)
+    {
+        wd_restart_record_t record = all[i];
+        size_t j = i;
+
+        for (; 0 < j && 0 < CompareRestartTime(all + j - 1, &record); --j)
+        {
+            all[j] = all[j - 1];
+        }
+
+        all[j] = record;
+    }
+
+    if (max_records < amount)
+    {
+        memcpy(records, all + amount - max_records,
+               max_records * sizeof(wd_restart_record_t));
+
+        return (max_records);
+    }
+
+    memcpy(records, all, amount * sizeof(wd_restart_record_t));
+
+    return (amount);
+}
+
+void WDKick(void)
+{
+    if (NULL != g_default_wd)
+    {
+        WDKickHandle(g_default_wd);
+    }
+}
+
+/* lost updates of concurrent kicks don't matter, any change is a kick */
+void WDKickHandle(wd_t *wd)
+{
+    assert(NULL != wd);
+
+    wd->app_kicks = wd->app_kicks + 1;
+}
+
+void WDProgress(size_t amount)
+{
+    if (NULL != g_default_wd)
+    {
+        WDProgressHandle(g_default_wd, amount);
+    }
+}
+
+/* as with the kicks, any change of the counter is progress */
+void WDProgressHandle(wd_t *wd, size_t amount)
+{
+    assert(NULL != wd);
+
+    wd->progress = wd->progress + amount;
+}
+
+wd_thread_t *WDRegisterThread(wd_t *wd, size_t deadline_ms,
+                              int is_report_only)
+{
+    size_t i = 0;
+
+    if (NULL == wd)
+    {
+        wd = g_default_wd;
+    }
+
+    if (NULL == wd || NULL == wd->shared)
+    {
+        return (NULL);
+    }
+
+    for (i = 0; i < WD_MAX_THREADS; ++i)
+    {
+        struct wd_thread *thread = &wd->shared->threads[i].thread;
+
+        if (__sync_bool_compare_and_swap(&thread->state, WD_SLOT_FREE,
+                                         WD_SLOT_CLAIMED))
+        {
+            thread->deadline_ms = (unsigned long)deadline_ms;
+            thread->is_report_only = is_report_only;
+            thread->is_late = FALSE;
+            ++thread->seq;
+
+            __sync_synchronize();
+            thread->state = WD_SLOT_ACTIVE;
+
+            return (thread);
+        }
+    }
+
+    return (NULL);
+}
+
+void WDThreadKick(wd_thread_t *thread)
+{
+    assert(NULL != thread);
+
+    thread->seq = thread->seq + 1;
+}
+
+int WDIsThreadLate(const wd_thread_t *thread)
+{
+    assert(NULL != thread);
+
+    return (thread->is_late);
+}
+
+void WDUnregisterThread(wd_thread_t *thread)
+{
+    assert(NULL != thread);
+
+    thread->state = WD_SLOT_FREE;
+}
+
+wd_recorder_t *WDRegisterRecorder(wd_t *wd)
+{
+    size_t i = 0;
+
+    if (NULL == wd)
+    {
+        wd = g_default_wd;
+    }
+
+    if (NULL == wd || NULL == wd->shared)
+    {
+        return (NULL);
+    }
+
+    for (i = 0; i < WD_MAX_RECORDERS; ++i)
+    {
+        struct wd_recorder *recorder = &wd->shared->recorders[i];
+
+        /* the events of the previous owner would pass for the new ones */
+        if (__sync_bool_compare_and_swap(&recorder->state, WD_SLOT_FREE,
+                                         WD_SLOT_CLAIMED))
+        {
+            memset(recorder->events, 0, sizeof(recorder->events));
+            recorder->head = 0;
+
+            __sync_synchronize();
+            recorder->state = WD_SLOT_ACTIVE;
+
+            return (recorder);
+        }
+    }
+
+    return (NULL);
+}
+
+/* a signal handler that records in the middle of a record of its thread
+   takes the next event, the interrupted one is published after it */
+void WDRecordEvent(wd_recorder_t *recorder, unsigned long code,
+                   unsigned long arg)
+{
+    struct timespec now = {0};
+    unsigned long index = 0;
+    wd_event_t *event = NULL;
+
+    assert(NULL != recorder);
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    index = __sync_fetch_and_add(&recorder->head, 1);
+    event = &recorder->events[index % WD_RECORDER_EVENTS];
+
+    event->time_ns = (unsigned long)now.tv_sec * NSEC_IN_SEC
+                   + (unsigned long)now.tv_nsec;
+    event->code = code;
+    event->arg = arg;
+
+    __sync_synchronize();
+    event->seq = index + 1;
+}
+
+/* the events stay to be dumped until the recorder is registered again */
+void WDUnregisterRecorder(wd_recorder_t *recorder)
+{
+    assert(NULL != recorder);
+
+    recorder->state = WD_SLOT_FREE;
+}
+
+int WDRegisterListener(wd_t *wd, size_t key, int fd)
+{
+    assert(key < WD_MAX_LISTENERS);
+    assert(0 <= fd);
+
+    if (NULL == wd)
+    {
+        wd = g_default_wd;
+    }
+
+    if (NULL == wd || NULL == wd->shared
+     || WDSendFd(wd->shared->listener_socks[WD_SIDE_APP], key, fd))
+    {
+        return (WD_FAILURE);
+    }
+
+    wd->listeners[key] = fd;
+
+    return (WD_SUCCESS);
+}
+
+int WDGetListener(const wd_t *wd, size_t key)
+{
+    assert(key < WD_MAX_LISTENERS);
+
+    if (NULL == wd)
+    {
+        wd = g_default_wd;
+    }
+
+    if (NULL == wd || NULL == wd->shared)
+    {
+        return (WD_NEG_FAILURE);
+    }
+
+    return (wd->listeners[key]);
+}
+
+void *WDCheckpointRegion(size_t size)
+{
+    if (NULL == g_default_wd)
+    {
+        return (NULL);
+    }
+
+    return (WDCheckpointRegionHandle(g_default_wd, size));
+}
+
+/* the watchdog holds the memfd of the region, the way it holds the
+   listening sockets, and passes it on to the restarted program */
+void *WDCheckpointRegionHandle(wd_t *wd, size_t size)
+{
+    struct stat info = {0};
+    void *region = NULL;
+    int fd = WD_NEG_FAILURE;
+
+    assert(NULL != wd);
+    assert(0 < size);
+
+    if (NULL == wd->shared)
+    {
+        return (NULL);
+    }
+
+    if (NULL != wd->checkpoint)
+    {
+        return ((size <= wd->checkpoint_size) ? wd->checkpoint : NULL);
+    }
+
+    fd = wd->checkpoint_fd;
+
+    if (WD_NEG_FAILURE == fd)
+    {
+        fd = (int)syscall(SYS_memfd_create, CHECKPOINT_NAME, MFD_CLOEXEC);
+        if (WD_NEG_FAILURE == fd)
+        {
+            return (NULL);
+        }
+
+        if (WDSendFd(wd->shared->listener_socks[WD_SIDE_APP], CHECKPOINT_KEY,
+                                                                        fd))
+        {
+            close(fd);
+            return (NULL);
+        }
+
+        wd->checkpoint_fd = fd;
+    }
+
+    /* the region of the previous instance is grown if asked for more */
+    if (WD_NEG_FAILURE == fstat(fd, &info)
+     || ((size_t)info.st_size < size
+      && WD_NEG_FAILURE == ftruncate(fd, (off_t)size)))
+    {
+        return (NULL);
+    }
+
+    region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == region)
+    {
+        return (NULL);
+    }
+
+    wd->checkpoint = region;
+    wd->checkpoint_size = size;
+
+    return (region);
+}
+
+int WDAwaitPromotion(wd_t *wd)
+{
+    wd_shared_t *shared = NULL;
+
+    if (NULL == wd)
+    {
+        wd = g_default_wd;
+    }
+
+    if (NULL == wd || !wd->is_standby)
+    {
+        return (WD_SUCCESS);
+    }
+
+    shared = wd->shared;
+
+    WDRaiseFlag(&shared->is_standby_parked);
+
+    /* the standby dies with the watchdog, see WDTakeStandby */
+    while (WDWaitFlag(&shared->is_standby_promoted, wd->downtime_ms))
+    {
+    }
+
+    /* the program outlives the watchdog like a restarted one */
+    prctl(PR_SET_PDEATHSIG, 0);
+
+    wd->is_standby = FALSE;
+
+    return (WDStartAdopted(wd));
+}
+
+int WDForkPoint(wd_t *wd)
+{
+    wd_shared_t *shared = NULL;
+    pid_t pid = 0;
+
+    if (NULL == wd)
+    {
+        wd = g_default_wd;
+    }
+
+    /* the forked programs are watched by their pidfds, they aren't children
+       of the watchdog */
+    if (NULL == wd || NULL == wd->shared || WD_RESTARTER_ID != wd->id
+     || 0 > wd->peer_pidfd)
+    {
+        return (WD_FAILURE);
+    }
+
+    shared = wd->shared;
+
+    /* the zygote of a previous instance keeps serving */
+    if (WDIsZygoteAlive(shared))
+    {
+        return (WD_SUCCESS);
+    }
+
+    /* the forked programs would print what is buffered again */
+    fflush(NULL);
+
+    pid = fork();
+    if (WD_NEG_FAILURE == pid)
+    {
+        return (WD_FAILURE);
+    }
+
+    if (0 != pid)
+    {
+        shared->zygote_pid = pid;
+
+        return (WD_SUCCESS);
+    }
+
+    return (WDRunZygote(wd));
+}
+
+int WDGetDetectorStats(const wd_t *wd, int is_watchdog,
+                       wd_detector_stats_t *stats)
+{
+    const wd_stats_slot_t *slot = NULL;
+    unsigned long seq = 0;
+
+    assert(NULL != stats);
+
+    if (NULL == wd)
+    {
+        wd = g_default_wd;
+    }
+
+    if (NULL == wd || NULL == wd->shared)
+    {
+        return (WD_FAILURE);
+    }
+
+    slot = &wd->shared->detectors[is_watchdog ? WD_SIDE_WD : WD_SIDE_APP];
+
+    /* the other process may be writing meanwhile, the read is retried */
+    do
+    {
+        seq = slot->seq;
+        __sync_synchronize();
+
+        *stats = slot->stats;
+        __sync_synchronize();
+    }
+    while (0 != (seq & 1) || seq != slot->seq);
+
+    return (WD_SUCCESS);
+}
+
+wd_status_t WDGetStatus(const wd_t *wd)
+{
+    assert(NULL != wd);
+
+    if (wd->is_given_up)
+    {
+        return (WD_STATUS_GAVE_UP);
+    }
+
+    if (wd->is_restart_pending)
+    {
+        return (WD_STATUS_RESTARTING);
+    }
+
+    return (WD_STATUS_WATCHING);
+}
+
+/* a program restarted by its watchdog is watched by it already, otherwise
+   the watchdog is spawned right away */
+static void *WDThread(void *argv)
+{
+    wd_t *wd = (wd_t *)argv;
+    int status = WD_SUCCESS;
+
+    if (0 == wd->observed_pid)
+    {
+        WDSpawnPeer(wd);
+        status = WDSyncPeer(wd);
+    }
+    else
+    {
+        status = WDWaitFlag(&wd->shared->is_ready[WD_SIDE_WD],
+                            wd->downtime_ms);
+    }
+
+    if (NULL != wd->on_ready)
+    {
+        wd->on_ready(status, wd->ready_param);
+    }
+
+    if (wd->wd_sig_stop_is_received)
+    {
+        return (NULL);
+    }
+
+    SchedulerRun(wd->scheduler);
+    
+    return (NULL);
+}
+
+static int WDInitHandle(wd_t *wd, int argc, char *argv[])
+{
+    WDInitParameters(wd, argc, argv);
+
+    if (WDInitScheduler(wd) || WDInitSigHandlers() || WDInitSharedMemory(wd))
+    {
+        return (WD_FAILURE);
+    }
+
+    return (WD_SUCCESS);
+}
+
+/* runs in the watchdog process until the watchdog is stopped */
+static int WDRunWatchdog(wd_t *wd, int argc, char *argv[])
+{
+    if (WDInitHandle(wd, argc, argv))
+    {
+        return (WD_FAILURE);
+    }
+
+    g_runner_wd = wd;
+    atexit(WDRunnerExit);
+
+    WDSetWdParams(wd);
+
+    /* see WDRunZygote */
+    if (WD_RESTARTER_ID == wd->id)
+    {
+        wd->shared->watchdog_pid = getpid();
+    }
+
+    WDSyncPeer(wd);
+
+    if (wd->is_hot_standby && WD_RESTARTER_ID == wd->id)
+    {
+        WDSpawnStandby(wd);
+    }
+
+    SchedulerRun(wd->scheduler);
+
+    WDRaiseFlag(&wd->shared->is_stop_acked);
+
+    return (WD_SUCCESS);
+}
+
+/* the supervisor watches the program, so the program only kicks it */
+static int WDStartSupervised(wd_t *wd, int argc, char *argv[])
+{
+    wd->wd_sig_stop_is_received = FALSE;
+    wd->shared = NULL;
+
+    wd->supervisor_fd = SupervisorRegister(wd->supervisor_path,
+                                           wd->downtime_ms, argc, argv);
+    if (WD_NEG_FAILURE == wd->supervisor_fd)
+    {
+        return (WD_FAILURE);
+    }
+
+    if (WDInitScheduler(wd)
+     || WD_SUCCESS != pthread_create(&wd->id_thread, NULL, WDKickThread, wd))
+    {
+        SupervisorUnregister(wd->supervisor_fd);
+        wd->supervisor_fd = WD_NEG_FAILURE;
+
+        return (WD_FAILURE);
+    }
+
+    return (WD_SUCCESS);
+}
+
+static void *WDKickThread(void *argv)
+{
+    wd_t *wd = (wd_t *)argv;
+
+    /* the supervisor has confirmed the registration already */
+    if (NULL != wd->on_ready)
+    {
+        wd->on_ready(WD_SUCCESS, wd->ready_param);
+    }
+
+    SchedulerRun(wd->scheduler);
+
+    return (NULL);
+}
+
+static int TaskReboot(void *argv)
+{
+    wd_t *wd = (wd_t *)argv;
+
+    if(wd->wd_sig_stop_is_received)
+    {
+        SchedulerStop(wd->scheduler);
+
+        return (WD_COMPLETE);
+    }
+
+    if(WDIsPeerWatched(wd) && !WDIsPeerAlive(wd))
+    {
+        WDLosePeer(wd, TRUE);
+    }
+
+    return (WD_RESCHEDULE);
+}
+
+static int TaskWatchExit(void *argv)
+{
+    wd_t *wd = (wd_t *)argv;
+
+    if(wd->wd_sig_stop_is_received)
+    {
+        SchedulerStop(wd->scheduler);
+
+        return (WD_COMPLETE);
+    }
+
+    if(WDIsPeerWatched(wd) && WDIsPeerExited(wd))
+    {
+        WDLosePeer(wd, FALSE);
+    }
+
+    return (WD_RESCHEDULE);
+}
+
+/* every thread of the program is checked against its own deadline */
+static int TaskScanThreads(void *argv)
+{
+    wd_t *wd = (wd_t *)argv;
+    unsigned long now_ms = WDNowMs();
+    size_t i = 0;
+
+    if (wd->wd_sig_stop_is_received || !WDIsPeerWatched(wd))
+    {
+        return (WD_RESCHEDULE);
+    }
+
+    for (i = 0; i < WD_MAX_THREADS; ++i)
+    {
+        struct wd_thread *thread = &wd->shared->threads[i].thread;
+        unsigned long seq = thread->seq;
+
+        if (WD_SLOT_ACTIVE != thread->state)
+        {
+            wd->is_thread_tracked[i] = FALSE;
+            continue;
+        }
+
+        if (!wd->is_thread_tracked[i] || seq != wd->thread_seqs[i])
+        {
+            wd->is_thread_tracked[i] = TRUE;
+            wd->thread_seqs[i] = seq;
+            wd->thread_kick_ms[i] = now_ms;
+            thread->is_late = FALSE;
+            continue;
+        }
+
+        if (now_ms - wd->thread_kick_ms[i] <= thread->deadline_ms)
+        {
+            continue;
+        }
+
+        if (thread->is_report_only)
+        {
+            thread->is_late = TRUE;
+            continue;
+        }
+
+        WDLosePeer(wd, TRUE);
+
+        break;
+    }
+
+    return (WD_RESCHEDULE);
+}
+
+static void WDClearThreads(wd_t *wd)
+{
+    memset(wd->shared->threads, 0, sizeof(wd->shared->threads));
+    memset(wd->is_thread_tracked, 0, sizeof(wd->is_thread_tracked));
+}
+
+static void WDClearRecorders(wd_t *wd)
+{
+    memset(wd->shared->recorders, 0, sizeof(wd->shared->recorders));
+}
+
+/* the program is dead, so nothing records while the rings are read. The
+   events of all the threads are written in the order they were recorded */
+static void WDDumpRecorders(wd_t *wd, const wd_restart_record_t *record)
+{
+    char name[RECORDER_FILE_SIZE] = {0};
+    wd_dumped_event_t *events = NULL;
+    size_t amount = 0;
+    size_t i = 0;
+    FILE *file = NULL;
+
+    events = (wd_dumped_event_t *)malloc(WD_MAX_RECORDERS
+                                * WD_RECORDER_EVENTS * sizeof(*events));
+    if (NULL == events)
+    {
+        return;
+    }
+
+    for (i = 0; i < WD_MAX_RECORDERS; ++i)
+    {
+        const struct wd_recorder *recorder = &wd->shared->recorders[i];
+        unsigned long head = recorder->head;
+        unsigned long index = 0;
+
+        if (WD_RECORDER_EVENTS < head)
+        {
+            index = head - WD_RECORDER_EVENTS;
+        }
+
+        /* an event the program died in the middle of isn't published */
+        for (; index < head; ++index)
+        {
+            const wd_event_t *event =
+                            &recorder->events[index % WD_RECORDER_EVENTS];
+
+            if (index + 1 == event->seq)
+            {
+                events[amount].time_ns = event->time_ns;
+                events[amount].recorder = i;
+                events[amount].code = event->code;
+                events[amount].arg = event->arg;
+                ++amount;
+            }
+        }
+    }
+
+    if (0 != amount
+     && WD_NEG_FAILURE != sprintf(name, RECORDER_FILE, (int)record->pid))
+    {
+        file = fopen(name, "w");
+    }
+
+    if (NULL != file)
+    {
+        qsort(events, amount, sizeof(*events), CompareEventTime);
+
+        fprintf(file, "# pid %d hang %d exit_code %d term_signal %d\n",
+                (int)record->pid, record->is_hang, record->exit_code,
+                record->term_signal);
+        fprintf(file, "# time_ns recorder code arg\n");
+
+        for (i = 0; i < amount; ++i)
+        {
+            fprintf(file, "%lu %lu %lu %lu\n", events[i].time_ns,
+                    (unsigned long)events[i].recorder, events[i].code,
+                    events[i].arg);
+        }
+
+        fclose(file);
+    }
+
+    free(events);
+}
+
+static int CompareEventTime(const void *event1, const void *event2)
+{
+    unsigned long time1 = ((const wd_dumped_event_t *)event1)->time_ns;
+    unsigned long time2 = ((const wd_dumped_event_t *)event2)->time_ns;
+
+    return ((time1 > time2) - (time1 < time2));
+}
+
+/* the peer is suspected by how late its kick is compared to the intervals
+   it has kept so far, the fixed downtime is left for the first kicks */
+static int TaskDetect(void *argv)
+{
+    wd_t *wd = (wd_t *)argv;
+    wd_detector_t *detector = &wd->detector;
+    unsigned long now_ms = WDNowMs();
+    unsigned long arrival_ms = 0;
+    unsigned long arrivals = 0;
+    double phi = 0.0;
+
+    if (wd->wd_sig_stop_is_received)
+    {
+        SchedulerStop(wd->scheduler);
+
+        return (WD_COMPLETE);
+    }
+
+    if (!WDIsPeerWatched(wd))
+    {
+        return (WD_RESCHEDULE);
+    }
+
+    arrivals = WDPeerArrivals(wd, &arrival_ms);
+
+    /* a new peer starts slower than it kicks, its first interval is left out */
+    if (detector->pid != wd->observed_pid)
+    {
+        detector->pid = wd->observed_pid;
+        detector->is_first = TRUE;
+        detector->arrivals = arrivals;
+        detector->last_ms = now_ms;
+    }
+
+    if (arrivals != detector->arrivals)
+    {
+        if (!detector->is_first && detector->last_ms < arrival_ms)
+        {
+            WDAddInterval(detector, (arrival_ms - detector->last_ms)
+                                            / (arrivals - detector->arrivals));
+        }
+
+        detector->is_first = FALSE;
+        detector->arrivals = arrivals;
+        detector->last_ms = arrival_ms;
+    }
+
+    phi = WDPhi(detector, now_ms - detector->last_ms);
+    WDPublishStats(wd, phi);
+
+    if (detector->is_first || detector->samples < PHI_MIN_SAMPLES)
+    {
+        if (wd->downtime_ms < now_ms - detector->last_ms)
+        {
+            WDLosePeer(wd, TRUE);
+        }
+    }
+    else if (wd->phi_threshold < phi)
+    {
+        WDLosePeer(wd, TRUE);
+    }
+
+    return (WD_RESCHEDULE);
+}
+
+/* a program that kicks without progress is as good as hung, the window
+   starts over with every change and with every new program */
+static int TaskCheckProgress(void *argv)
+{
+    wd_t *wd = (wd_t *)argv;
+    unsigned long now_ms = WDNowMs();
+    unsigned long progress = 0;
+
+    if (wd->wd_sig_stop_is_received || !WDIsPeerWatched(wd))
+    {
+        return (WD_RESCHEDULE);
+    }
+
+    progress = WDPeerProgress(wd);
+
+    if (wd->progress_pid != wd->observed_pid
+     || progress != wd->checked_progress)
+    {
+        wd->progress_pid = wd->observed_pid;
+        wd->checked_progress = progress;
+        wd->progress_ms = now_ms;
+
+        return (WD_RESCHEDULE);
+    }
+
+    if (wd->progress_window_ms < now_ms - wd->progress_ms)
+    {
+        wd->is_peer_stalled = TRUE;
+        WDLosePeer(wd, TRUE);
+    }
+
+    return (WD_RESCHEDULE);
+}
+
+static unsigned long WDPeerProgress(const wd_t *wd)
+{
+    if (WD_HEARTBEAT_SHARED_MEMORY == wd->heartbeat)
+    {
+        return (wd->shared->beats[WD_SIDE_APP].progress);
+    }
+
+    return (wd->peer_progress);
+}
+
+/* counts the kicks of the peer so far and tells the time of the last one */
+static unsigned long WDPeerArrivals(const wd_t *wd, unsigned long *last_ms)
+{
+    if (WD_HEARTBEAT_SHARED_MEMORY == wd->heartbeat)
+    {
+        const wd_beat_t *beat = &wd->shared->beats[wd->is_wd ? WD_SIDE_APP
+                                                                : WD_SIDE_WD];
+        unsigned long seq = beat->seq;
+
+        *last_ms = WDToMs(&beat->kick_time);
+
+        return (seq);
+    }
+
+    *last_ms = wd->peer_kick_ms;
+
+    return (wd->peer_kicks);
+}
+
+static void WDAddInterval(wd_detector_t *detector, unsigned long interval_ms)
+{
+    double sum = 0.0;
+    double deviations = 0.0;
+    double min_stddev = 0.0;
+    size_t i = 0;
+
+    detector->intervals[detector->next] = interval_ms;
+    detector->next = (detector->next + 1) % PHI_WINDOW;
+
+    if (detector->samples < PHI_WINDOW)
+    {
+        ++detector->samples;
+    }
+
+    for (i = 0; i < detector->samples; ++i)
+    {
+        sum += (double)detector->intervals[i];
+    }
+
+    detector->mean_ms = sum / (double)detector->samples;
+
+    for (i = 0; i < detector->samples; ++i)
+    {
+        double deviation = (double)detector->intervals[i] - detector->mean_ms;
+
+        deviations += deviation * deviation;
+    }
+
+    detector->stddev_ms = sqrt(deviations / (double)detector->samples);
+
+    /* a peer that has been very regular isn't suspected for a few ms late */
+    min_stddev = detector->mean_ms / PHI_MIN_STDDEV_DIVISOR;
+
+    if (detector->stddev_ms < min_stddev)
+    {
+        detector->stddev_ms = min_stddev;
+    }
+}
+
+/* phi = -log10 of the probability that the kick comes even later, the
+   normal distribution is approximated by the logistic one */
+static double WDPhi(const wd_detector_t *detector, unsigned long elapsed_ms)
+{
+    double y = 0.0;
+    double z = 0.0;
+
+    if (detector->samples < PHI_MIN_SAMPLES || 0.0 == detector->stddev_ms)
+    {
+        return (0.0);
+    }
+
+    y = ((double)elapsed_ms - detector->mean_ms) / detector->stddev_ms;
+    z = y * (1.5976 + 0.070566 * y * y);
+
+    /* log10(1 + exp(z)) without overflowing exp */
+    if (PHI_LINEAR_Z < z)
+    {
+        return (z / log(10.0));
+    }
+
+    return (log10(1.0 + exp(z)));
+}
+
+static void WDPublishStats(wd_t *wd, double phi)
+{
+    wd_detector_t *detector = &wd->detector;
+    wd_stats_slot_t *slot = &wd->shared->detectors[wd->is_wd ? WD_SIDE_WD
+                                                                : WD_SIDE_APP];
+
+    if (detector->max_phi < phi)
+    {
+        detector->max_phi = phi;
+    }
+
+    __sync_add_and_fetch(&slot->seq, 1);
+
+    slot->stats.samples = detector->samples;
+    slot->stats.mean_ms = detector->mean_ms;
+    slot->stats.stddev_ms = detector->stddev_ms;
+    slot->stats.phi = phi;
+    slot->stats.max_phi = detector->max_phi;
+
+    __sync_add_and_fetch(&slot->seq, 1);
+}
+
+/* the peer is dead while its restart is delayed or given up */
+static int WDIsPeerWatched(const wd_t *wd)
+{
+    return (!wd->is_restart_pending && !wd->is_given_up);
+}
+
+/* only one of the watchdogs of the program restarts it, the others exit and
+   are spawned again by the restarted program */
+static void WDLosePeer(wd_t *wd, int is_hang)
+{
+    if (wd->is_wd && WD_RESTARTER_ID != wd->id)
+    {
+        if (is_hang)
+        {
+            kill(wd->observed_pid, SIGKILL);
+        }
+
+        SchedulerStop(wd->scheduler);
+
+        return;
+    }
+
+    WDRestartPeer(wd, is_hang);
+}
+
+static void WDRestartPeer(wd_t *wd, int is_hang)
+{
+    wd_restart_record_t *record = &wd->pending_record;
+    int status = wd->peer_status;
+    size_t recent_restarts = 0;
+    size_t backoff_ms = 0;
+
+    memset(record, 0, sizeof(wd_restart_record_t));
+
+    record->is_watchdog = !wd->is_wd;
+    record->is_hang = is_hang;
+    record->is_stalled = wd->is_peer_stalled;
+    record->pid = wd->observed_pid;
+    clock_gettime(CLOCK_REALTIME, &record->exit_time);
+
+    if (is_hang)
+    {
+        kill(record->pid, SIGKILL);
+        WDReapPeer(wd, 0);
+        status = wd->peer_status;
+    }
+
+    record->is_status_known = wd->is_peer_reaped;
+    record->exit_code = -1;
+
+    if (wd->is_peer_reaped)
+    {
+        if (WIFEXITED(status))
+        {
+            record->exit_code = WEXITSTATUS(status);
+        }
+        else if (WIFSIGNALED(status))
+        {
+            record->term_signal = WTERMSIG(status);
+#ifdef WCOREDUMP
+            record->core_dumped = (0 != WCOREDUMP(status));
+#endif
+        }
+    }
+
+    wd->is_peer_reaped = FALSE;
+    wd->is_peer_stalled = FALSE;
+
+    if (wd->is_wd)
+    {
+        WDDumpRecorders(wd, record);
+    }
+
+    recent_restarts = WDCountRecentRestarts(wd, WDNowMs());
+
+    if (0 != wd->max_restarts && wd->max_restarts <= recent_restarts)
+    {
+        WDGiveUp(wd);
+        return;
+    }
+
+    backoff_ms = WDBackoffMs(wd, recent_restarts);
+
+    if (0 == backoff_ms)
+    {
+        WDReplacePeer(wd);
+        return;
+    }
+
+    /* the peer is dead meanwhile, the tasks leave it alone until then */
+    wd->is_restart_pending = TRUE;
+
+    if (UIDIsSame(BadUID, SchedulerAddTaskMs(wd->scheduler, TaskRestart,
+                                             TaskCleanupDummy, wd, NULL,
+                                             backoff_ms)))
+    {
+        wd->is_restart_pending = FALSE;
+        WDReplacePeer(wd);
+    }
+}
+
+static int TaskRestart(void *argv)
+{
+    wd_t *wd = (wd_t *)argv;
+
+    if (!wd->wd_sig_stop_is_received)
+    {
+        WDReplacePeer(wd);
+    }
+
+    wd->is_restart_pending = FALSE;
+
+    return (WD_COMPLETE);
+}
+
+static void WDReplacePeer(wd_t *wd)
+{
+    wd_restart_record_t *record = &wd->pending_record;
+
+    wd->restart_times[wd->restarts_amount % WD_HISTORY_SIZE] = WDNowMs();
+    ++wd->restarts_amount;
+
+    /* the threads of the dead program don't kick or record anymore, and
+       the sockets it registered last are passed on too */
+    if (wd->is_wd)
+    {
+        WDClearThreads(wd);
+        WDClearRecorders(wd);
+        WDReceiveListeners(wd);
+    }
+
+    record->is_standby = WDPromoteStandby(wd);
+    record->is_zygote = !record->is_standby && WDForkFromZygote(wd);
+
+    if (!record->is_standby && !record->is_zygote)
+    {
+        WDSpawnPeer(wd);
+    }
+
+    record->new_pid = wd->observed_pid;
+    clock_gettime(CLOCK_REALTIME, &record->restart_time);
+
+    WDRecordRestart(wd, record);
+
+    /* the restarted program sees its restart in the history */
+    WDSyncPeer(wd);
+
+    if (wd->is_wd && wd->is_hot_standby && 0 == wd->standby_pid)
+    {
+        WDSpawnStandby(wd);
+    }
+}
+
+/* only a parked standby is promoted, one that is still warming up is
+   replaced together with the program */
+static int WDPromoteStandby(wd_t *wd)
+{
+    wd_shared_t *shared = wd->shared;
+
+    if (0 == wd->standby_pid)
+    {
+        return (FALSE);
+    }
+
+    if (!shared->is_standby_parked)
+    {
+        WDKillStandby(wd);
+
+        return (FALSE);
+    }
+
+    shared->is_ready[WD_SIDE_APP] = FALSE;
+    shared->is_ready[WD_SIDE_WD] = FALSE;
+
+    wd->observed_pid = wd->standby_pid;
+    wd->standby_pid = 0;
+    WDWatchPeer(wd);
+
+    wd->is_peer_restarted = TRUE;
+
+    WDRaiseFlag(&shared->is_standby_promoted);
+
+    return (TRUE);
+}
+
+/* the standby is the program started the same way a restarted one is, it
+   finds out it is the standby in the environment, like the shared memory */
+static void WDSpawnStandby(wd_t *wd)
+{
+    char name[ARG_STR_SIZE] = {0};
+    pid_t pid = 0;
+
+    wd->shared->is_standby_parked = FALSE;
+    wd->shared->is_standby_promoted = FALSE;
+
+    if (WD_NEG_FAILURE == sprintf(name, "%s%lu", STANDBY_ENV, wd->id)
+     || WD_NEG_FAILURE == setenv(name, "1", TRUE))
+    {
+        return;
+    }
+
+    pid = WDExecPeer(wd);
+    unsetenv(name);
+
+    wd->standby_pid = (WD_NEG_FAILURE == pid) ? 0 : pid;
+}
+
+static void WDKillStandby(wd_t *wd)
+{
+    if (0 == wd->standby_pid)
+    {
+        return;
+    }
+
+    kill(wd->standby_pid, SIGKILL);
+    waitpid(wd->standby_pid, NULL, 0);
+
+    wd->standby_pid = 0;
+}
+
+/* the zygote forks the program as it was at the fork point, which skips
+   exec and the initialization of the program */
+static int WDForkFromZygote(wd_t *wd)
+{
+    wd_shared_t *shared = wd->shared;
+
+    if (!wd->is_wd || 0 > wd->peer_pidfd || !WDIsZygoteAlive(shared))
+    {
+        return (FALSE);
+    }
+
+    shared->is_ready[WD_SIDE_APP] = FALSE;
+    shared->is_ready[WD_SIDE_WD] = FALSE;
+    shared->is_forked = FALSE;
+
+    WDRaiseFlag(&shared->is_fork_requested);
+
+    if (WDWaitFlag(&shared->is_forked, wd->downtime_ms)
+     || 0 >= shared->forked_pid)
+    {
+        shared->is_fork_requested = FALSE;
+
+        return (FALSE);
+    }
+
+    wd->observed_pid = shared->forked_pid;
+    WDWatchPeer(wd);
+
+    wd->is_peer_restarted = TRUE;
+
+    return (TRUE);
+}
+
+/* the zygote only forks, for the restarting watchdog of the moment, and
+   exits once there is none. It returns only in a forked program */
+static int WDRunZygote(wd_t *wd)
+{
+    wd_shared_t *shared = wd->shared;
+    pid_t pid = 0;
+
+    /* the forked programs are reaped by the system */
+    signal(SIGCHLD, SIG_IGN);
+
+    for (;;)
+    {
+        while (WDWaitFlag(&shared->is_fork_requested, wd->downtime_ms))
+        {
+            if (WD_NEG_FAILURE == kill(shared->watchdog_pid, 0))
+            {
+                _exit(WD_SUCCESS);
+            }
+        }
+
+        shared->is_fork_requested = FALSE;
+
+        pid = fork();
+        if (0 == pid)
+        {
+            break;
+        }
+
+        shared->forked_pid = pid;
+        WDRaiseFlag(&shared->is_forked);
+    }
+
+    signal(SIGCHLD, SIG_DFL);
+
+    /* the scheduler was copied from the middle of a run of the thread that
+       wasn't forked, it is left as is */
+    wd->observed_pid = shared->watchdog_pid;
+    WDWatchPeer(wd);
+
+    if (WDInitScheduler(wd))
+    {
+        _exit(WD_FAILURE);
+    }
+
+    return (WDStartAdopted(wd));
+}
+
+/* kill(pid, 0) succeeds for a zombie too, the pidfd of the zygote is
+   readable once it has exited */
+static int WDIsZygoteAlive(const wd_shared_t *shared)
+{
+    pid_t pid = shared->zygote_pid;
+    int pidfd = WD_NEG_FAILURE;
+    int is_alive = FALSE;
+
+    if (0 == pid)
+    {
+        return (FALSE);
+    }
+
+    /* a dead zygote forked by this program is reaped on the way */
+    if (pid == waitpid(pid, NULL, WNOHANG))
+    {
+        return (FALSE);
+    }
+
+#ifdef SYS_pidfd_open
+    pidfd = (int)syscall(SYS_pidfd_open, pid, 0);
+#endif
+
+    if (0 > pidfd)
+    {
+        return (WD_SUCCESS == kill(pid, 0));
+    }
+
+    {
+        struct pollfd pfd = {0};
+
+        pfd.fd = pidfd;
+        pfd.events = POLLIN;
+
+        is_alive = (0 == poll(&pfd, 1, 0));
+    }
+
+    close(pidfd);
+
+    return (is_alive);
+}
+
+static void WDKillZygote(wd_t *wd)
+{
+    pid_t zygote_pid = wd->shared->zygote_pid;
+
+    if (wd->is_wd || WD_RESTARTER_ID != wd->id || 0 == zygote_pid)
+    {
+        return;
+    }
+
+    kill(zygote_pid, SIGKILL);
+
+    /* only the program that forked the zygote reaps it */
+    waitpid(zygote_pid, NULL, 0);
+
+    wd->shared->zygote_pid = 0;
+}
+
+/* the program takes over from a dead one while the watchdog waits for it.
+   The tasks may have been scheduled long ago, the watchdog gets a full
+   downtime from now on */
+static int WDStartAdopted(wd_t *wd)
+{
+    wd_shared_t *shared = wd->shared;
+
+    wd->is_peer_restarted = TRUE;
+    wd->wd_sig_is_received = FALSE;
+    wd->peer_seq = shared->beats[WD_SIDE_WD].seq;
+    memset(&shared->detectors[WD_SIDE_APP], 0, sizeof(wd_stats_slot_t));
+
+    WDRaiseFlag(&shared->is_ready[WD_SIDE_APP]);
+
+    if (WD_SUCCESS != pthread_create(&wd->id_thread, NULL, WDThread, wd))
+    {
+        return (WD_FAILURE);
+    }
+
+    if (NULL == wd->on_ready)
+    {
+        WDSyncApp(wd);
+    }
+
+    return (WD_SUCCESS);
+}
+
+/* a standby that crashes while it warms up is started again, no more than
+   once every downtime */
+static int TaskWatchStandby(void *argv)
+{
+    wd_t *wd = (wd_t *)argv;
+
+    if (wd->wd_sig_stop_is_received || !WDIsPeerWatched(wd))
+    {
+        return (WD_RESCHEDULE);
+    }
+
+    if (0 != wd->standby_pid
+     && wd->standby_pid == waitpid(wd->standby_pid, NULL, WNOHANG))
+    {
+        wd->standby_pid = 0;
+    }
+
+    if (0 == wd->standby_pid)
+    {
+        WDSpawnStandby(wd);
+    }
+
+    return (WD_RESCHEDULE);
+}
+
+/* the watchdog has no one to report to but the history, it exits and
+   leaves the history to the next instance of the program */
+static void WDGiveUp(wd_t *wd)
+{
+    wd_restart_record_t *record = &wd->pending_record;
+
+    wd->is_given_up = TRUE;
+
+    record->is_given_up = TRUE;
+    clock_gettime(CLOCK_REALTIME, &record->restart_time);
+
+    WDRecordRestart(wd, record);
+
+    if (wd->is_wd)
+    {
+        SchedulerStop(wd->scheduler);
+    }
+    else if (NULL != wd->on_give_up)
+    {
+        wd->on_give_up(wd->give_up_param);
+    }
+}
+
+static size_t WDCountRecentRestarts(wd_t *wd, unsigned long now_ms)
+{
+    size_t amount = 0;
+    size_t kept = wd->restarts_amount;
+    size_t i = 0;
+
+    if (WD_HISTORY_SIZE < kept)
+    {
+        kept = WD_HISTORY_SIZE;
+    }
+
+    for (i = 0; i < kept; ++i)
+    {
+        amount += (now_ms - wd->restart_times[i] < wd->restart_window_ms);
+    }
+
+    return (amount);
+}
+
+/* the first restart in the window is immediate, the next ones wait twice
+   as long as the previous ones, and a random half of the wait is cut off,
+   so peers that crashed together don't restart together */
+static size_t WDBackoffMs(wd_t *wd, size_t recent_restarts)
+{
+    size_t backoff_ms = wd->backoff_min_ms;
+    size_t i = 1;
+
+    if (0 == backoff_ms || 0 == recent_restarts)
+    {
+        return (0);
+    }
+
+    for (i = 1; i < recent_restarts && backoff_ms < wd->backoff_max_ms; ++i)
+    {
+        backoff_ms *= 2;
+    }
+
+    if (wd->backoff_max_ms < backoff_ms)
+    {
+        backoff_ms = wd->backoff_max_ms;
+    }
+
+    return (backoff_ms - (size_t)rand_r(&wd->jitter_seed)
+                                                    % (backoff_ms / 2 + 1));
+}
+
+static unsigned long WDNowMs(void)
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (WDToMs(&now));
+}
+
+static unsigned long WDToMs(const struct timespec *time)
+{
+    return ((unsigned long)time->tv_sec * MSEC_IN_SEC
+          + (unsigned long)(time->tv_nsec / NSEC_IN_MSEC));
+}
+
+static void WDRecordRestart(wd_t *wd, const wd_restart_record_t *record)
+{
+    wd_history_t *history = &wd->shared->history[wd->is_wd ? WD_SIDE_WD
+                                                                 : WD_SIDE_APP];
+
+    history->records[history->count % WD_HISTORY_SIZE] = *record;
+
+    __sync_synchronize();
+    ++history->count;
+}
+
+static int CompareRestartTime(const wd_restart_record_t *record1,
+                              const wd_restart_record_t *record2)
+{
+    if (record1->restart_time.tv_sec != record2->restart_time.tv_sec)
+    {
+        return (record1->restart_time.tv_sec < record2->restart_time.tv_sec
+                                                                    ? -1 : 1);
+    }
+
+    if (record1->restart_time.tv_nsec != record2->restart_time.tv_nsec)
+    {
+        return (record1->restart_time.tv_nsec < record2->restart_time.tv_nsec
+                                                                    ? -1 : 1);
+    }
+
+    return (0);
+}
+
+static void WDSpawnPeer(wd_t *wd)
+{
+    pid_t pid = 0;
+
+    /* the flags are raised again once the new peer is up, and the own one
+       after the restart is recorded, see WDSyncPeer */
+    wd->shared->is_ready[WD_SIDE_APP] = FALSE;
+    wd->shared->is_ready[WD_SIDE_WD] = FALSE;
+
+    /* a new watchdog inherits the sockets of the program itself */
+    if (!wd->is_wd)
+    {
+        memcpy(wd->shared->listeners, wd->listeners, sizeof(wd->listeners));
+        wd->shared->checkpoint_fd = wd->checkpoint_fd;
+    }
+
+    pid = WDExecPeer(wd);
+    if (WD_NEG_FAILURE == pid)
+    {
+        exit(WD_FAILURE);
+    }
+
+    wd->observed_pid = pid;
+    WDWatchPeer(wd);
+
+    /* the new peer gets a full downtime to send the first kick */
+    wd->is_peer_restarted = TRUE;
+}
+
+/* fork copies the page tables of the caller, the others don't. The fds
+   shared with the peer are close-on-exec, only the peer inherits them */
+static pid_t WDExecPeer(wd_t *wd)
+{
+    char **wd_argv = wd->wd_argv;
+    int fds[INHERITED_FDS_AMOUNT] = {0};
+    size_t fds_amount = WDInheritedFds(wd, fds);
+    size_t i = 0;
+    pid_t pid = 0;
+
+    if (WD_SPAWN_POSIX_SPAWN == wd->spawn)
+    {
+        posix_spawn_file_actions_t actions;
+        int status = WD_SUCCESS;
+
+        /* dup2 to the same fd only clears close-on-exec */
+        if (WD_SUCCESS != posix_spawn_file_actions_init(&actions))
+        {
+            return (WD_NEG_FAILURE);
+        }
+
+        for (i = 0; i < fds_amount && WD_SUCCESS == status; ++i)
+        {
+            status = posix_spawn_file_actions_adddup2(&actions, fds[i],
+                                                      fds[i]);
+        }
+
+        status = status
+              || posix_spawnp(&pid, wd_argv[0], &actions, NULL, wd_argv,
+                              environ);
+
+        posix_spawn_file_actions_destroy(&actions);
+
+        return (WD_SUCCESS == status ? pid : WD_NEG_FAILURE);
+    }
+
+    if (WD_SPAWN_VFORK == wd->spawn)
+    {
+        pid = vfork();
+    }
+    else
+    {
+        pid = fork();
+    }
+
+    if (0 == pid)
+    {
+        for (i = 0; i < fds_amount; ++i)
+        {
+            fcntl(fds[i], F_SETFD, 0);
+        }
+
+        execvp(wd_argv[0], wd_argv);
+        _exit(WD_FAILURE);
+    }
+
+    return (pid);
+}
+
+/* pidfd becomes readable when the process exits, a non-child too */
+static void WDWatchPeer(wd_t *wd)
+{
+    if (0 <= wd->peer_pidfd)
+    {
+        close(wd->peer_pidfd);
+    }
+
+    wd->peer_pidfd = WD_NEG_FAILURE;
+
+#ifdef SYS_pidfd_open
+    wd->peer_pidfd = (int)syscall(SYS_pidfd_open,
+                                          wd->observed_pid, 0);
+#endif
+}
+
+static int WDIsPeerExited(wd_t *wd)
+{
+    pid_t pid = wd->observed_pid;
+    pid_t reaped = 0;
+
+    if (0 <= wd->peer_pidfd)
+    {
+        struct pollfd pfd = {0};
+
+        pfd.fd = wd->peer_pidfd;
+        pfd.events = POLLIN;
+
+        if (1 != poll(&pfd, 1, 0))
+        {
+            return (FALSE);
+        }
+
+        /* the peer has exited, so reaping it doesn't block */
+        WDReapPeer(wd, 0);
+
+        return (TRUE);
+    }
+
+    /* no pidfd support: the peer is either our child or our parent */
+    reaped = WDReapPeer(wd, WNOHANG);
+    if (WD_NEG_FAILURE == reaped && ECHILD == errno)
+    {
+        return (getppid() != pid);
+    }
+
+    return (pid == reaped);
+}
+
+/* only the parent can reap, for any other process waitpid fails at once */
+static pid_t WDReapPeer(wd_t *wd, int options)
+{
+    int status = 0;
+    pid_t reaped = waitpid(wd->observed_pid, &status, options);
+
+    if (wd->observed_pid == reaped)
+    {
+        wd->is_peer_reaped = TRUE;
+        wd->peer_status = status;
+    }
+
+    return (reaped);
+}
+
+static int WDInitScheduler(wd_t *wd)
+{
+    nsrd_uid_t uid_kick = BadUID;
+	nsrd_uid_t uid_reboot = BadUID;
+	nsrd_uid_t uid_watch = BadUID;
+	nsrd_uid_t uid_scan = BadUID;
+	nsrd_uid_t uid_detect = BadUID;
+	nsrd_uid_t uid_progress = BadUID;
+	nsrd_uid_t uid_listen = BadUID;
+	nsrd_uid_t uid_standby = BadUID;
+    size_t exit_check_ms = EXIT_CHECK_MS;
+
+    scheduler_t * scheduler = SchedulerCreate();
+    if (NULL == scheduler)
+	{
+		return (WD_FAILURE);
+	}
+
+    if (wd->kicktime_ms < exit_check_ms)
+    {
+        exit_check_ms = wd->kicktime_ms;
+    }
+
+    wd->scheduler = scheduler;
+
+    uid_kick = SchedulerAddTaskMs(scheduler, TaskKick, TaskCleanupDummy, wd,
+                                  NULL, wd->kicktime_ms);
+    if (UIDIsSame(uid_kick, BadUID))
+    {
+        return (WD_FAILURE);
+    }
+
+    if (0 <= wd->supervisor_fd)
+    {
+        return (WD_SUCCESS);
+    }
+
+    /* the detector samples every kick, so it runs only if it decides */
+    if (0.0 < wd->phi_threshold)
+    {
+        uid_detect = SchedulerAddTaskMs(scheduler, TaskDetect,
+                                        TaskCleanupDummy, wd, NULL,
+                                        exit_check_ms);
+        if (UIDIsSame(uid_detect, BadUID))
+        {
+            return (WD_FAILURE);
+        }
+    }
+    else
+    {
+        uid_reboot = SchedulerAddTaskMs(scheduler, TaskReboot,
+                                        TaskCleanupDummy, wd, NULL,
+                                        wd->downtime_ms);
+        if (UIDIsSame(uid_reboot, BadUID))
+        {
+            return (WD_FAILURE);
+        }
+    }
+
+    uid_watch = SchedulerAddTaskMs(scheduler, TaskWatchExit, TaskCleanupDummy,
+                                   wd, NULL, exit_check_ms);
+    if (UIDIsSame(uid_watch, BadUID))
+    {
+        return (WD_FAILURE);
+    }
+
+    if (!wd->is_wd)
+    {
+        return (WD_SUCCESS);
+    }
+
+    uid_scan = SchedulerAddTaskMs(scheduler, TaskScanThreads, TaskCleanupDummy,
+                                  wd, NULL, wd->kicktime_ms);
+    if (UIDIsSame(uid_scan, BadUID))
+    {
+        return (WD_FAILURE);
+    }
+
+    uid_listen = SchedulerAddTaskMs(scheduler, TaskReceiveListeners,
+                                    TaskCleanupDummy, wd, NULL,
+                                    wd->kicktime_ms);
+    if (UIDIsSame(uid_listen, BadUID))
+    {
+        return (WD_FAILURE);
+    }
+
+    if (wd->is_hot_standby && WD_RESTARTER_ID == wd->id)
+    {
+        uid_standby = SchedulerAddTaskMs(scheduler, TaskWatchStandby,
+                                         TaskCleanupDummy, wd, NULL,
+                                         wd->downtime_ms);
+        if (UIDIsSame(uid_standby, BadUID))
+        {
+            return (WD_FAILURE);
+        }
+    }
+
+    if (0 != wd->progress_window_ms)
+    {
+        uid_progress = SchedulerAddTaskMs(scheduler, TaskCheckProgress,
+                                          TaskCleanupDummy, wd, NULL,
+                                          wd->kicktime_ms);
+        if (UIDIsSame(uid_progress, BadUID))
+        {
+            return (WD_FAILURE);
+        }
+    }
+
+    return (WD_SUCCESS);
+}
+
+static int TaskKick(void *argv)
+{
+    wd_t *wd = (wd_t *)argv;
+
+    assert(NULL != wd);
+
+    /* the thread vouches only for a program that has kicked since then */
+    if (wd->is_app_kicked && !wd->is_wd)
+    {
+        unsigned long app_kicks = wd->app_kicks;
+
+        if (app_kicks == wd->forwarded_kicks)
+        {
+            return (WD_RESCHEDULE);
+        }
+
+        wd->forwarded_kicks = app_kicks;
+    }
+
+    if (0 <= wd->supervisor_fd)
+    {
+        SupervisorKick(wd->supervisor_fd);
+    }
+    else if (!WDIsPeerWatched(wd))
+    {
+        return (WD_RESCHEDULE);
+    }
+    else if (WD_HEARTBEAT_SHARED_MEMORY == wd->heartbeat)
+    {
+        WDBeat(wd);
+    }
+    else
+    {
+        union sigval progress;
+
+        /* the low bits of the progress are enough to notice a change */
+        progress.sival_int = (int)wd->progress;
+        sigqueue(wd->observed_pid, SIGUSR1, progress);
+    }
+
+	return (WD_RESCHEDULE);
+}
+
+static void TaskCleanupDummy(void *cleanup_params)
+{
+    (void) cleanup_params;
+}
+
+static void HandleKick(int sig, siginfo_t *info, void *context)
+{
+    unsigned long now_ms = WDNowMs();
+    size_t slot = 0;
+
+    __sync_fetch_and_add(&g_handlers_running, 1);
+
+    for (slot = 0; slot < WD_MAX_HANDLES; ++slot)
+    {
+        wd_t *wd = g_handles[slot];
+
+        if (NULL != wd && info->si_pid == wd->observed_pid)
+        {
+            wd->wd_sig_is_received = TRUE;
+            wd->peer_kick_ms = now_ms;
+            ++wd->peer_kicks;
+
+            if (SI_QUEUE == info->si_code)
+            {
+                wd->peer_progress = (unsigned int)info->si_value.sival_int;
+            }
+        }
+    }
+
+    __sync_fetch_and_sub(&g_handlers_running, 1);
+
+    (void) sig;
+    (void) context;
+}
+
+static void HandleStop(int sig, siginfo_t *info, void *context)
 {
-    int wd_sig_is_received;
-    int wd_sig_stop_is_received;
-    int wd_argc;
-    size_t kicktime;
-    size_t downtime;
-    pthread_t id_thread;
-    pid_t observed_pid;
-    scheduler_t *scheduler;
-    sem_t *sem_thread;
-    sem_t *sem_process;
-    char sem_thread_name[MAX_ARGS_AMOUNT];
-    char sem_process_name[MAX_ARGS_AMOUNT];
-    char *wd_argv[MAX_ARGS_AMOUNT];
-} wdparams_t;
+    size_t slot = 0;
 
+    __sync_fetch_and_add(&g_handlers_running, 1);
 
-static int WDInitSemophores(void);
-static void WDGraceExit(void);
-static int WDInitSigHandlers(void);
-static void *WDThread(void *argv);
-static int WDInitScheduler(void);
-static void WDInitParameters(int argc, char *argv[], size_t downtime);
-static int WDSetAppParams(void);
-static void WDSetWdParams(void);
-static int WDSyncThreads(sem_t *posted_sem, sem_t *waited_sem);
-static int WDSyncApp(void);
-static void WDWaitSeconds(size_t seconds);
-static void HandleKick(int sig);
-static int TaskKick(void *operation_params);
-static void TaskCleanupDummy(void *cleanup_params);
-static int TaskReboot(void *argv);
+    for (slot = 0; slot < WD_MAX_HANDLES; ++slot)
+    {
+        wd_t *wd = g_handles[slot];
 
+        if (NULL != wd && info->si_pid == wd->observed_pid)
+        {
+            wd->wd_sig_stop_is_received = TRUE;
+        }
+    }
 
-const int __attribute__((weak)) g_is_wd;
-wdparams_t g_wd_params;
+    __sync_fetch_and_sub(&g_handlers_running, 1);
 
+    (void) sig;
+    (void) context;
+}
 
-int WDStart(int argc, char *argv[], size_t downtime)
+static int WDInitSigHandlers(void)
 {
-    assert(NULL != argv[0]);
-    assert(0 < argc);
-    assert(5 <= downtime);
+    struct sigaction act = {0};
 
-    WDInitParameters(argc, argv, downtime);
+    act.sa_flags = SA_SIGINFO;
+    act.sa_sigaction = HandleKick;
 
-    if (WDInitScheduler() || WDInitSigHandlers() || WDInitSemophores())
+    if (WD_NEG_FAILURE == sigaction(SIGUSR1, &act, NULL))
     {
         return (WD_FAILURE);
     }
-    
-    if (!g_is_wd)
+
+    act.sa_sigaction = HandleStop;
+
+    if (WD_NEG_FAILURE == sigaction(SIGUSR2, &act, NULL))
+    {
+        return (WD_FAILURE);
+    }
+
+    return (WD_SUCCESS);
+}
+
+static int WDIsPeerAlive(wd_t *wd)
+{
+    int is_alive = FALSE;
+
+    if (wd->is_peer_restarted)
+    {
+        wd->is_peer_restarted = FALSE;
+        wd->wd_sig_is_received = FALSE;
+
+        return (TRUE);
+    }
+
+    if (WD_HEARTBEAT_SHARED_MEMORY == wd->heartbeat)
+    {
+        int peer = wd->is_wd ? WD_SIDE_APP : WD_SIDE_WD;
+        unsigned long seq = wd->shared->beats[peer].seq;
+
+        is_alive = (seq != wd->peer_seq);
+        wd->peer_seq = seq;
+
+        return (is_alive);
+    }
+
+    is_alive = wd->wd_sig_is_received;
+    wd->wd_sig_is_received = FALSE;
+
+    return (is_alive);
+}
+
+static void WDBeat(wd_t *wd)
+{
+    wd_beat_t *beat = &wd->shared->beats[wd->is_wd ? WD_SIDE_WD
+                                                          : WD_SIDE_APP];
+
+    clock_gettime(CLOCK_MONOTONIC, &beat->kick_time);
+    beat->progress = wd->progress;
+    __sync_add_and_fetch(&beat->seq, 1);
+}
+
+/* the mapping is inherited through its fd: the watchdog gets it in the
+   arguments, and the program restarted by the watchdog in the environment */
+static int WDInitSharedMemory(wd_t *wd)
+{
+    wd_shared_t *shared = NULL;
+    int fd = wd->shared_fd;
+
+    if (!wd->is_wd)
+    {
+        fd = WDTakeInheritedFd(wd);
+    }
+
+    if (WD_NEG_FAILURE != fd)
+    {
+        shared = WDMapShared(fd);
+    }
+
+    /* only the restarter exports the memory, the program is its child */
+    if (NULL != shared && !wd->is_wd)
     {
-        if(WDSetAppParams())
+        wd->observed_pid = getppid();
+        WDWatchPeer(wd);
+        wd->is_standby = WDTakeStandby(wd);
+    }
+
+    if (NULL == shared)
+    {
+        if (wd->is_wd)
+        {
+            return (WD_FAILURE);
+        }
+
+        fd = WDCreateShared();
+        if (WD_NEG_FAILURE == fd)
+        {
+            return (WD_FAILURE);
+        }
+
+        shared = WDMapShared(fd);
+        if (NULL == shared)
         {
+            close(fd);
             return (WD_FAILURE);
         }
 
-        if (WD_SUCCESS != pthread_create(&g_wd_params.id_thread, NULL, WDThread,
-                                         NULL))
+        if (WDInitListeners(shared))
         {
+            munmap(shared, sizeof(wd_shared_t));
+            close(fd);
             return (WD_FAILURE);
         }
+
+        shared->magic = SHARED_MAGIC;
     }
-    else
+
+    wd->shared_fd = fd;
+    wd->shared = shared;
+
+    /* the peer is the only process to inherit them, see WDExecPeer */
+    WDCloseOnExec(wd);
+
+    if (!wd->is_wd)
     {
-        atexit(WDGraceExit);
+        memcpy(wd->listeners, shared->listeners, sizeof(wd->listeners));
+        wd->checkpoint_fd = shared->checkpoint_fd;
+    }
 
-        WDSetWdParams();
+    wd->peer_seq = shared->beats[wd->is_wd ? WD_SIDE_APP
+                                                 : WD_SIDE_WD].seq;
 
-        WDSyncThreads(g_wd_params.sem_process, g_wd_params.sem_thread);
+    if (wd->is_wd && WD_RESTARTER_ID == wd->id && WDExportSharedFd(wd))
+    {
+        return (WD_FAILURE);
+    }
 
-        SchedulerRun(g_wd_params.scheduler);
+    /* the program runs meanwhile, see WDAwaitPromotion */
+    if (wd->is_standby)
+    {
+        return (WD_SUCCESS);
+    }
 
-        kill(g_wd_params.observed_pid, SIGUSR2);
+    /* slots left by a previous run of the program */
+    if (!wd->is_wd)
+    {
+        WDClearThreads(wd);
+        WDClearRecorders(wd);
     }
-    
-    WDSyncApp();
+
+    memset(&shared->detectors[wd->is_wd ? WD_SIDE_WD : WD_SIDE_APP], 0,
+                                                    sizeof(wd_stats_slot_t));
 
     return (WD_SUCCESS);
 }
 
-void WDStop(void)
+/* a standby that isn't promoted must not outlive the watchdog, nothing
+   would promote or stop it */
+static int WDTakeStandby(const wd_t *wd)
 {
-    int i = 0;
+    char name[ARG_STR_SIZE] = {0};
 
-    SchedulerStop(g_wd_params.scheduler);
-
-    while (!g_wd_params.wd_sig_stop_is_received && CLOSE_ATTEMPTS_AMOUNT > i++)
+    if (WD_NEG_FAILURE == sprintf(name, "%s%lu", STANDBY_ENV, wd->id)
+     || NULL == getenv(name))
     {
-        kill(g_wd_params.observed_pid, SIGUSR2);
-        WDWaitSeconds(g_wd_params.downtime);
+        return (FALSE);
     }
-    
-    pthread_join(g_wd_params.id_thread, NULL);
 
-    WDGraceExit();
+    unsetenv(name);
 
-    sem_unlink(g_wd_params.sem_process_name);
-    sem_unlink(g_wd_params.sem_thread_name);
-}
-
-static void *WDThread(void *argv)
-{
-    WDWaitSeconds(g_wd_params.kicktime * 2);
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
 
-	TaskReboot(NULL);
+    /* the watchdog died before the signal was set */
+    if (getppid() != wd->observed_pid)
+    {
+        exit(WD_FAILURE);
+    }
 
-    SchedulerRun(g_wd_params.scheduler);
-    
-    return (NULL);
-    (void) argv;
+    return (TRUE);
 }
 
-static int TaskReboot(void *argv)
+/* the variable isn't passed on to the children of the program */
+static int WDTakeInheritedFd(const wd_t *wd)
 {
-    pid_t pid = 0;
+    char name[ARG_STR_SIZE] = {0};
+    const char *value = NULL;
+    struct stat info = {0};
+    int fd = WD_NEG_FAILURE;
 
-    if(g_wd_params.wd_sig_stop_is_received)
+    if (WD_NEG_FAILURE == sprintf(name, "%s%lu", SHARED_FD_ENV, wd->id))
     {
-        SchedulerStop(g_wd_params.scheduler);
+        return (WD_NEG_FAILURE);
+    }
 
-        return (WD_COMPLETE);
+    value = getenv(name);
+    if (NULL == value)
+    {
+        return (WD_NEG_FAILURE);
     }
 
-    if(!g_wd_params.wd_sig_is_received)
+    fd = (int)strtol(value, NULL, 10);
+    unsetenv(name);
+
+    if (WD_NEG_FAILURE == fstat(fd, &info)
+     || sizeof(wd_shared_t) != (size_t)info.st_size)
     {
-        pid = fork();
-        if (WD_NEG_FAILURE == pid)
-        {
-            exit(WD_FAILURE);
-        }
+        return (WD_NEG_FAILURE);
+    }
 
-        if (0 == pid)
-        {
-            if (WD_NEG_FAILURE == execvp(g_wd_params.wd_argv[0],
-                                         g_wd_params.wd_argv))
-            {
-                exit(WD_FAILURE);
-            }
-        }
-        else
-        {
-            g_wd_params.observed_pid = pid;
+    return (fd);
+}
 
-            WDSyncThreads(g_wd_params.sem_thread, g_wd_params.sem_process);
-        }
+static int WDCreateShared(void)
+{
+    int fd = (int)syscall(SYS_memfd_create, SHARED_NAME, MFD_CLOEXEC);
+    if (WD_NEG_FAILURE == fd)
+    {
+        return (WD_NEG_FAILURE);
     }
-    else
+
+    if (WD_NEG_FAILURE == ftruncate(fd, sizeof(wd_shared_t)))
     {
-        g_wd_params.wd_sig_is_received = FALSE;
+        close(fd);
+        return (WD_NEG_FAILURE);
     }
-    
-    return (WD_RESCHEDULE);
-    (void) argv;
+
+    return (fd);
 }
 
-static int WDInitScheduler(void)
+/* an fd that isn't a mapping of a watchdog is left alone */
+static wd_shared_t *WDMapShared(int fd)
 {
-    nsrd_uid_t uid_kick = BadUID;
-	nsrd_uid_t uid_reboot = BadUID;
+    wd_shared_t *shared = (wd_shared_t *)mmap(NULL, sizeof(wd_shared_t),
+                                              PROT_READ | PROT_WRITE,
+                                              MAP_SHARED, fd, 0);
+    if (MAP_FAILED == shared)
+    {
+        return (NULL);
+    }
 
-    scheduler_t * scheduler = SchedulerCreate();
-    if (NULL == scheduler)
-	{
-		return (WD_FAILURE);
-	}
+    if (0 != shared->magic && SHARED_MAGIC != shared->magic)
+    {
+        munmap(shared, sizeof(wd_shared_t));
+        return (NULL);
+    }
 
-    g_wd_params.scheduler = scheduler;
+    return (shared);
+}
 
-    uid_kick = SchedulerAddTask(scheduler, TaskKick, TaskCleanupDummy, NULL,
-                                NULL, g_wd_params.kicktime);
-    if (UIDIsSame(uid_kick, BadUID))
+/* the program restarted by the watchdog finds the mapping by its handle */
+static int WDExportSharedFd(const wd_t *wd)
+{
+    char name[ARG_STR_SIZE] = {0};
+    char value[ARG_STR_SIZE] = {0};
+
+    if (WD_NEG_FAILURE == sprintf(name, "%s%lu", SHARED_FD_ENV, wd->id)
+     || WD_NEG_FAILURE == sprintf(value, "%d", wd->shared_fd))
     {
         return (WD_FAILURE);
     }
 
-    uid_reboot = SchedulerAddTask(scheduler, TaskReboot, TaskCleanupDummy, NULL,
-                                  NULL, g_wd_params.downtime);
-    if (UIDIsSame(uid_reboot, BadUID))
+    return (WD_NEG_FAILURE == setenv(name, value, TRUE));
+}
+
+/* the program sends on its end, the watchdog receives on the other one.
+   Both processes keep both ends, to pass them on to the next peer */
+static int WDInitListeners(wd_shared_t *shared)
+{
+    int socks[WD_SIDES_AMOUNT] = {0};
+    size_t key = 0;
+
+    if (WD_NEG_FAILURE == socketpair(AF_UNIX, SOCK_SEQPACKET, 0, socks))
     {
         return (WD_FAILURE);
     }
 
+    shared->listener_socks[WD_SIDE_APP] = socks[WD_SIDE_APP];
+    shared->listener_socks[WD_SIDE_WD] = socks[WD_SIDE_WD];
+
+    for (key = 0; key < WD_MAX_LISTENERS; ++key)
+    {
+        shared->listeners[key] = WD_NEG_FAILURE;
+    }
+
+    shared->checkpoint_fd = WD_NEG_FAILURE;
+
     return (WD_SUCCESS);
 }
 
-static int TaskKick(void *argv)
+static void WDCloseOnExec(const wd_t *wd)
 {
-    assert(NULL != &g_wd_params);
- 
-    kill(g_wd_params.observed_pid, SIGUSR1);
+    int fds[INHERITED_FDS_AMOUNT] = {0};
+    size_t fds_amount = WDInheritedFds(wd, fds);
+    size_t i = 0;
 
-	return (WD_RESCHEDULE);
-    (void) argv;
+    for (i = 0; i < fds_amount; ++i)
+    {
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+    }
 }
 
-static void TaskCleanupDummy(void *cleanup_params)
+/* an inherited fd keeps its number, so the numbers in the shared memory are
+   valid in the peer too */
+static size_t WDInheritedFds(const wd_t *wd, int *fds)
 {
-    (void) cleanup_params;
+    const wd_shared_t *shared = wd->shared;
+    size_t amount = 0;
+    size_t key = 0;
+
+    fds[amount++] = wd->shared_fd;
+    fds[amount++] = shared->listener_socks[WD_SIDE_APP];
+    fds[amount++] = shared->listener_socks[WD_SIDE_WD];
+
+    for (key = 0; key < WD_MAX_LISTENERS; ++key)
+    {
+        if (0 <= shared->listeners[key])
+        {
+            fds[amount++] = shared->listeners[key];
+        }
+    }
+
+    if (0 <= shared->checkpoint_fd)
+    {
+        fds[amount++] = shared->checkpoint_fd;
+    }
+
+    return (amount);
 }
 
-static void HandleKick(int sig)
+static int TaskReceiveListeners(void *argv)
 {
-    g_wd_params.wd_sig_is_received = TRUE;
+    wd_t *wd = (wd_t *)argv;
 
-    (void) sig;
+    if (!wd->wd_sig_stop_is_received)
+    {
+        WDReceiveListeners(wd);
+    }
+
+    return (WD_RESCHEDULE);
 }
 
-static void HandleStop(int sig)
+/* the watchdog holds a duplicate of every socket the program registered,
+   a socket registered again replaces the previous one. The memfd of the
+   checkpoint region comes the same way, under a key of its own */
+static void WDReceiveListeners(wd_t *wd)
 {
-    g_wd_params.wd_sig_stop_is_received = TRUE;
+    wd_shared_t *shared = wd->shared;
+    size_t key = 0;
+    int fd = WD_NEG_FAILURE;
 
-    (void) sig;
+    while (WD_SUCCESS == WDRecvFd(shared->listener_socks[WD_SIDE_WD], &key,
+                                                                        &fd))
+    {
+        int *held = NULL;
+
+        if (CHECKPOINT_KEY < key)
+        {
+            close(fd);
+            continue;
+        }
+
+        held = (CHECKPOINT_KEY == key) ? &shared->checkpoint_fd
+                                       : &shared->listeners[key];
+
+        if (0 <= *held)
+        {
+            close(*held);
+        }
+
+        *held = fd;
+
+        /* the standby doesn't have the new fd, it is started again */
+        WDKillStandby(wd);
+    }
 }
 
-static int WDInitSigHandlers(void)
+static int WDSendFd(int sock, size_t key, int fd)
 {
-    struct sigaction act = {0};
+    struct msghdr msg = {0};
+    struct iovec iov = {0};
+    struct cmsghdr *cmsg = NULL;
+    union
+    {
+        struct cmsghdr header;
+        char buffer[CMSG_SPACE(sizeof(int))];
+    } control;
 
-    act.sa_handler = HandleKick;
+    memset(&control, 0, sizeof(control));
 
-    if (WD_NEG_FAILURE == sigaction(SIGUSR1, &act, NULL))
+    iov.iov_base = &key;
+    iov.iov_len = sizeof(key);
+
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+    return (WD_NEG_FAILURE == sendmsg(sock, &msg, 0));
+}
+
+/* the received fd is close-on-exec like the other fds shared with the peer */
+static int WDRecvFd(int sock, size_t *key, int *fd)
+{
+    struct msghdr msg = {0};
+    struct iovec iov = {0};
+    struct cmsghdr *cmsg = NULL;
+    union
+    {
+        struct cmsghdr header;
+        char buffer[CMSG_SPACE(sizeof(int))];
+    } control;
+
+    memset(&control, 0, sizeof(control));
+
+    iov.iov_base = key;
+    iov.iov_len = sizeof(*key);
+
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+
+    if (sizeof(*key) != recvmsg(sock, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC))
     {
         return (WD_FAILURE);
     }
 
-    act.sa_handler = HandleStop;
-
-    if (WD_NEG_FAILURE == sigaction(SIGUSR2, &act, NULL))
+    cmsg = CMSG_FIRSTHDR(&msg);
+    if (NULL == cmsg || SOL_SOCKET != cmsg->cmsg_level
+     || SCM_RIGHTS != cmsg->cmsg_type)
     {
         return (WD_FAILURE);
     }
 
+    memcpy(fd, CMSG_DATA(cmsg), sizeof(int));
+
     return (WD_SUCCESS);
 }
 
-static int WDInitSemophores(void)
+/* the scheduler isn't running anymore: its thread is joined, or it is the
+   main thread of the watchdog which has already returned from SchedulerRun */
+static void WDGraceExit(wd_t *wd)
 {
-    char *sem_thread_name = g_wd_params.sem_thread_name;
-    char *sem_process_name = g_wd_params.sem_process_name;
-    sem_t *sem_thread = NULL;
-    sem_t *sem_process = NULL;
-    char *str = NULL;
-    key_t key = 0;
+    SchedulerStop(wd->scheduler);
 
-    if (!g_is_wd)
+    WDKillStandby(wd);
+
+    SchedulerClear(wd->scheduler);
+    SchedulerDestroy(wd->scheduler);
+
+    if (NULL != wd->checkpoint)
     {
-        str = g_wd_params.wd_argv[0];
+        munmap(wd->checkpoint, wd->checkpoint_size);
+        wd->checkpoint = NULL;
     }
-    else
+
+    if (0 <= wd->checkpoint_fd)
     {
-        str = g_wd_params.wd_argv[2];
+        close(wd->checkpoint_fd);
+        wd->checkpoint_fd = WD_NEG_FAILURE;
     }
 
-    key = ftok(str, getpgid(getpid()));
+    if (NULL != wd->shared)
+    {
+        close(wd->shared->listener_socks[WD_SIDE_APP]);
+        close(wd->shared->listener_socks[WD_SIDE_WD]);
+
+        munmap(wd->shared, sizeof(wd_shared_t));
+        wd->shared = NULL;
+    }
 
-    if (WD_NEG_FAILURE == key 
-     || WD_NEG_FAILURE == sprintf(sem_thread_name, "%d", key + 1) 
-     || WD_NEG_FAILURE == sprintf(sem_process_name, "%d", key + 2))
+    if (0 <= wd->shared_fd)
     {
-        return (WD_FAILURE);
+        close(wd->shared_fd);
+        wd->shared_fd = WD_NEG_FAILURE;
     }
-    
-    sem_thread = sem_open(sem_thread_name, O_CREAT, 0666, 0);
-    sem_process = sem_open(sem_process_name, O_CREAT, 0666, 0);
-    
-    if (SEM_FAILED == sem_thread || SEM_FAILED == sem_process)
+
+    if (0 <= wd->peer_pidfd)
     {
-        return (WD_FAILURE);
+        close(wd->peer_pidfd);
+        wd->peer_pidfd = WD_NEG_FAILURE;
     }
+}
+
+/* both sides raise their flags and wait for the flag of each other, a peer
+   that doesn't come up in the downtime is left to the watching tasks */
+static int WDSyncPeer(wd_t *wd)
+{
+    wd_shared_t *shared = wd->shared;
 
-    g_wd_params.sem_thread = sem_thread;
-    g_wd_params.sem_process = sem_process;
+    WDRaiseFlag(&shared->is_ready[wd->is_wd ? WD_SIDE_WD : WD_SIDE_APP]);
 
-    return (WD_SUCCESS);
+    return (WDWaitFlag(&shared->is_ready[wd->is_wd ? WD_SIDE_APP
+                                                   : WD_SIDE_WD],
+                       wd->downtime_ms));
 }
 
-static void WDGraceExit(void)
+static void WDRunnerExit(void)
 {
-    SchedulerStop(g_wd_params.scheduler);
-    WDWaitSeconds(g_wd_params.downtime);
+    WDGraceExit(g_runner_wd);
+}
 
-    SchedulerClear(g_wd_params.scheduler);
-    SchedulerDestroy(g_wd_params.scheduler);
+/* the program is watched once both sides are up */
+static int WDSyncApp(wd_t *wd)
+{
+    wd_shared_t *shared = wd->shared;
 
-    sem_close(g_wd_params.sem_process);
-    sem_close(g_wd_params.sem_thread);
+	return (WDWaitFlag(&shared->is_ready[WD_SIDE_WD], wd->downtime_ms)
+         || WDWaitFlag(&shared->is_ready[WD_SIDE_APP], wd->downtime_ms));
 }
 
-static int WDSyncThreads(sem_t *posted_sem, sem_t *waited_sem)
+static void WDRaiseFlag(volatile int *flag)
 {
-    assert(NULL != posted_sem);
-    assert(NULL != waited_sem);
+    __sync_synchronize();
+    *flag = TRUE;
 
-	return (sem_post(posted_sem)||sem_wait(waited_sem)||sem_post(waited_sem));
+    syscall(SYS_futex, (int *)flag, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
 }
 
-static int WDSyncApp(void)
+/* the futex is in memory shared between processes, so it isn't private */
+static int WDWaitFlag(volatile int *flag, size_t timeout_ms)
 {
-    sem_t *sem_thread = g_wd_params.sem_thread;
-    sem_t *sem_process = g_wd_params.sem_process;
+    unsigned long deadline_ms = WDNowMs() + timeout_ms;
+
+    while (!*flag)
+    {
+        struct timespec timeout = {0};
+        unsigned long now_ms = WDNowMs();
 
-	return (sem_wait(sem_thread)||sem_post(sem_thread)||
-           sem_wait(sem_process)||sem_post(sem_process));
+        if (deadline_ms <= now_ms)
+        {
+            return (WD_FAILURE);
+        }
+
+        timeout.tv_sec = (time_t)((deadline_ms - now_ms) / MSEC_IN_SEC);
+        timeout.tv_nsec = (long)((deadline_ms - now_ms) % MSEC_IN_SEC)
+                                                                * NSEC_IN_MSEC;
+
+        syscall(SYS_futex, (int *)flag, FUTEX_WAIT, FALSE, &timeout, NULL, 0);
+    }
+
+    return (WD_SUCCESS);
 }
 
-static void WDInitParameters(int argc, char *argv[], size_t downtime)
+static void WDInitParameters(wd_t *wd, int argc, char *argv[])
 {
 	int i = 0;
     char **wd_argv = NULL;
 
     assert(NULL != argv);
-    assert(5 <= downtime);
 
-    g_wd_params.wd_argc = argc;
+    wd->wd_argc = argc;
 
-    wd_argv = g_wd_params.wd_argv;
+    wd_argv = wd->wd_argv;
 
 	for (i = 0; i < argc; ++i)
 	{
 		wd_argv[i] = argv[i];
 	}
 
-    g_wd_params.downtime = downtime;
-    g_wd_params.kicktime = downtime / KICKTIME_FREQUENCY;
+    wd->shared = NULL;
+
+    wd->wd_sig_is_received = 0;
+    wd->wd_sig_stop_is_received = 0;
+
+    wd->is_peer_restarted = FALSE;
+    wd->peer_pidfd = WD_NEG_FAILURE;
+    wd->is_peer_reaped = FALSE;
+    wd->peer_status = 0;
+
+    wd->is_restart_pending = FALSE;
+    wd->is_given_up = FALSE;
+    wd->restarts_amount = 0;
+    wd->is_standby = FALSE;
+    wd->standby_pid = 0;
+
+    wd->peer_kicks = 0;
+    wd->peer_kick_ms = 0;
+    wd->peer_progress = 0;
+    wd->progress_pid = WD_NEG_FAILURE;
+    wd->is_peer_stalled = FALSE;
+    memset(&wd->detector, 0, sizeof(wd_detector_t));
+    wd->detector.pid = WD_NEG_FAILURE;
+    wd->jitter_seed = (unsigned int)getpid() ^ (unsigned int)WDNowMs();
+
+    if (wd->is_wd)
+    {
+        wd->id = strtoul(argv[WD_ARGS_OFFSET - 1], NULL, 10);
+        wd->shared_fd = (int)strtol(argv[WD_SHARED_FD_ARG], NULL, 10);
+    }
 
-    g_wd_params.wd_sig_is_received = 0;
-    g_wd_params.wd_sig_stop_is_received = 0;
+    /* a restarted program adopts its parent once it finds the shared
+       memory of the restarter, see WDInitSharedMemory */
+    wd->observed_pid = 0;
 
-    g_wd_params.observed_pid = getppid();
+    if (wd->is_wd)
+    {
+        wd->observed_pid = getppid();
+        WDWatchPeer(wd);
+    }
 }
 
-static int WDSetAppParams(void)
+static int WDSetAppParams(wd_t *wd)
 {
 	int i = 0;
-    int wd_argc = g_wd_params.wd_argc;
-    char **wd_argv = g_wd_params.wd_argv;
-    size_t downtime = g_wd_params.downtime;
-	static char downtime_str[20] = {0};
-
-    if (WD_NEG_FAILURE == sprintf(downtime_str, "%ld", downtime))
+    int wd_argc = wd->wd_argc;
+    char **wd_argv = wd->wd_argv;
+    unsigned long options[WD_OPTION_ARGS] = {0};
+
+    /* the same order is parsed by the runner, the id goes last */
+    options[0] = (unsigned long)wd->downtime_ms;
+    options[1] = (unsigned long)wd->kicktime_ms;
+    options[2] = (unsigned long)wd->heartbeat;
+    options[3] = (unsigned long)wd->spawn;
+    options[4] = (unsigned long)wd->max_restarts;
+    options[5] = (unsigned long)wd->restart_window_ms;
+    options[6] = (unsigned long)wd->backoff_min_ms;
+    options[7] = (unsigned long)wd->backoff_max_ms;
+    options[8] = (unsigned long)(wd->phi_threshold * PHI_SCALE);
+    options[9] = (unsigned long)wd->progress_window_ms;
+    options[10] = (unsigned long)wd->is_hot_standby;
+    options[11] = (unsigned long)wd->shared_fd;
+    options[12] = wd->id;
+
+    if (MAX_ARGS_AMOUNT <= wd_argc + WD_ARGS_OFFSET)
     {
         return (WD_FAILURE);
     }
 
-	for (i = wd_argc + 1; 1 < i; --i)
+	for (i = wd_argc + WD_ARGS_OFFSET - 1; WD_ARGS_OFFSET <= i; --i)
 	{
-		wd_argv[i] = wd_argv[i - 2];
+		wd_argv[i] = wd_argv[i - WD_ARGS_OFFSET];
 	}
 
 	wd_argv[0] = PATH_TO_WATCHDOG;
-	wd_argc += 2;
-	wd_argv[1] = downtime_str;
+
+    for (i = 0; i < WD_OPTION_ARGS; ++i)
+    {
+        if (WD_NEG_FAILURE == sprintf(wd->option_strs[i], "%lu", options[i]))
+        {
+            return (WD_FAILURE);
+        }
+
+        wd_argv[i + 1] = wd->option_strs[i];
+    }
+
+	wd_argc += WD_ARGS_OFFSET;
 	wd_argv[wd_argc] = NULL;
 
+    wd->wd_argc = wd_argc;
+
     return (WD_SUCCESS);
 }
 
-static void WDSetWdParams(void)
+static void WDSetWdParams(wd_t *wd)
 {
 	int i = 0;
-    int wd_argc = g_wd_params.wd_argc;
-    char **wd_argv = g_wd_params.wd_argv;
+    int wd_argc = wd->wd_argc;
+    char **wd_argv = wd->wd_argv;
+
+	wd_argc -= WD_ARGS_OFFSET;
 
 	for (i = 0; i < wd_argc; ++i)
 	{
-		wd_argv[i] = wd_argv[i + 2];
+		wd_argv[i] = wd_argv[i + WD_ARGS_OFFSET];
 	}
 
-	wd_argc -= 2;
+	wd_argv[wd_argc] = NULL;
+
+    wd->wd_argc = wd_argc;
 }
 
-static void WDWaitSeconds(size_t seconds)
+static int WDWaitStopAck(wd_t *wd, size_t timeout_ms)
 {
-	while (0 < seconds)
-	{		
-		seconds = sleep(seconds);
-	}	
-}
\ No newline at end of file
+    return (WDWaitFlag(&wd->shared->is_stop_acked, timeout_ms));
+}
@@ -10,22 +10,50 @@
 * 
 *******************************************************************************/
 #include <assert.h> /* assert */
-#include <stdlib.h> /* atoi */
+#include <stdlib.h> /* strtoul */
+#include <string.h> /* strcmp */
 
 #include "watchdog.h"
 
+#define SUPERVISOR_ARG ("--supervisor")
+#define PHI_SCALE (1000.0) /* the threshold is passed in thousandths */
+#define MIN_ARGS (14) /* the path, the options, the shared fd and the id */
+
+enum {WD_SUCCESS, WD_FAILURE};
+
 const int g_is_wd = 1;
 
 int main(int argc, char *argv[])
 {
-    size_t downtime = 0;
+    wd_options_t options = {0};
+
+    if (3 == argc && 0 == strcmp(argv[1], SUPERVISOR_ARG))
+    {
+        return (WDSupervise(argv[2]));
+    }
+
+    /* the runner is only started by the watchdog, anything else is refused
+       rather than read out of argv */
+    if (MIN_ARGS > argc)
+    {
+        return (WD_FAILURE);
+    }
 
-    assert(0 < argc);
     assert(NULL != argv[0]);
 
-    downtime = atol(argv[1]);
+    options.downtime_ms = strtoul(argv[1], NULL, 10);
+    options.kicktime_ms = strtoul(argv[2], NULL, 10);
+    options.heartbeat = (wd_heartbeat_t)strtoul(argv[3], NULL, 10);
+    options.spawn = (wd_spawn_t)strtoul(argv[4], NULL, 10);
+    options.max_restarts = strtoul(argv[5], NULL, 10);
+    options.restart_window_ms = strtoul(argv[6], NULL, 10);
+    options.backoff_min_ms = strtoul(argv[7], NULL, 10);
+    options.backoff_max_ms = strtoul(argv[8], NULL, 10);
+    options.phi_threshold = (double)strtoul(argv[9], NULL, 10) / PHI_SCALE;
+    options.progress_window_ms = strtoul(argv[10], NULL, 10);
+    options.is_hot_standby = (int)strtoul(argv[11], NULL, 10);
 
-    WDStart(argc, argv, downtime);
+    WDStartEx(argc, argv, &options);
 
-    return (0);
+    return (WD_SUCCESS);
 }
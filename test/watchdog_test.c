@@ -2,35 +2,453 @@
 *
 * FILENAME : watchdog_test.c
 *
-* DESCRIPTION : Test of the watchdog.
-* 
+* DESCRIPTION : Test of the watchdog. Every test runs a scenario as a program
+* of its own, which is watched, crashed, hung and restarted like any other
+* program. The instances of the program report to the test through a pipe
+* they all inherit. Run it from a directory next to the watchdog executable,
+* with the name of a test to run only that test.
+*
 * AUTHOR : Nick Shenderov
 *
 * DATE : 10.07.23
-* 
+*
 *******************************************************************************/
 
-#include <time.h> /* time */
-#include <stdio.h> /* printf */
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h> /* time, nanosleep, clock_gettime */
+#include <stdio.h> /* printf, sprintf, fopen */
+#include <stdlib.h> /* strtol, strtoul */
+#include <string.h> /* strcmp, strlen, strstr */
+#include <errno.h> /* errno, EINTR */
+#include <signal.h> /* raise, kill */
+#include <unistd.h> /* fork, execv, pipe, _exit */
+#include <poll.h> /* poll */
+#include <dirent.h> /* opendir */
+#include <fcntl.h> /* open */
+#include <pthread.h> /* pthread_create */
+#include <sys/wait.h> /* waitpid */
+#include <sys/socket.h> /* socket */
+#include <netinet/in.h> /* sockaddr_in */
+#include <arpa/inet.h> /* htonl */
 
 #include "watchdog.h" /* watchdog */
+#include "testing.h" /* TH_ASSERT */
 
 #define DOWNTIME (5)
 #define TIMEOUT (20)
 #define PRINT_INTEVAL (1)
+#define DOWNTIME_MS (1000)
+#define LONG_DOWNTIME_MS (5000)
+#define KICKTIME_MS (100)
+#define KICKS (10)
+#define STALL_MS (5 * DOWNTIME_MS)
+#define DETECTION_MS (500)
+#define STOP_MS (200)
+#define BACKOFF_MS (200)
+#define THREAD_DEADLINE_MS (500)
+#define PHI_THRESHOLD (8.0)
+#define PHI_KICKS (30)
+#define PROGRESS_WINDOW_MS (1000)
+#define LISTENER_KEY (3)
+#define CHECKPOINT_SIZE (64)
+#define EVENT_CODE (25)
+#define EVENT_ARG (42)
+#define LAUNCH_TIMEOUT_MS (60000)
+#define REPORT_SIZE (4096)
+#define LINE_SIZE (128)
+#define CRASH_CODE (3)
+#define MSEC_IN_SEC (1000)
+#define NSEC_IN_MSEC (1000000L)
+#define VALUE_FILE ("watchdog_test.value")
+#define SOCKET_PATH ("watchdog_test.sock")
+#define RESTARTED_FILE ("watchdog_test.restarted")
+#define SUPERVISOR_ARG ("--supervisor")
+#define CHECKPOINT ("checkpoint")
+#define MESSAGE ("hello")
+#define DONE ("done\n")
+#define FAIL ("fail")
 
-static void WaitFor(unsigned int secs)
+#define CHECK(BOOL) Check((BOOL), __LINE__)
+
+enum {FALSE, TRUE};
+enum {NOT_READY, READY, NOT_STARTED};
+
+typedef struct scenario
 {
-    unsigned int retTime = time(0) + secs;
-    while (time(0) < retTime);
-}
+    const char *name;
+    int (*Run)(int argc, char *argv[]);
+} scenario_t;
+
+static int Launch(const char *name);
+static int RunScenario(int argc, char *argv[]);
+static int RunStart(int argc, char *argv[]);
+static int RunSharedMemory(int argc, char *argv[]);
+static int RunExitDetection(int argc, char *argv[]);
+static int RunRestartHistory(int argc, char *argv[]);
+static int RunPosixSpawn(int argc, char *argv[]);
+static int RunVfork(int argc, char *argv[]);
+static int RunSpawn(int argc, char *argv[], wd_spawn_t spawn);
+static int RunStopAck(int argc, char *argv[]);
+static int RunHandles(int argc, char *argv[]);
+static int RunSupervisor(int argc, char *argv[]);
+static int RunRestartLimit(int argc, char *argv[]);
+static int RunAppKick(int argc, char *argv[]);
+static int RunThreads(int argc, char *argv[]);
+static void *StallThread(void *param);
+static int RunPhi(int argc, char *argv[]);
+static int RunProgress(int argc, char *argv[]);
+static int RunInheritedMemory(int argc, char *argv[]);
+static size_t CountSharedMemory(void);
+static int RunStartAsync(int argc, char *argv[]);
+static void OnReady(int status, void *param);
+static int RunListener(int argc, char *argv[]);
+static int RunStandby(int argc, char *argv[]);
+static int RunZygote(int argc, char *argv[]);
+static int RunCheckpoint(int argc, char *argv[]);
+static int RunRecorder(int argc, char *argv[]);
+static void TestStart(void);
+static void TestSharedMemory(void);
+static void TestExitDetection(void);
+static void TestRestartHistory(void);
+static void TestPosixSpawn(void);
+static void TestVfork(void);
+static void TestStopAck(void);
+static void TestHandles(void);
+static void TestSupervisor(void);
+static void TestRestartLimit(void);
+static void TestAppKick(void);
+static void TestThreads(void);
+static void TestPhi(void);
+static void TestProgress(void);
+static void TestInheritedMemory(void);
+static void TestStartAsync(void);
+static void TestListener(void);
+static void TestStandby(void);
+static void TestZygote(void);
+static void TestCheckpoint(void);
+static void TestRecorder(void);
+static int Check(int is_true, int line);
+static void Report(const char *message);
+static void Done(void);
+static void Crash(void);
+static void Hang(void);
+static size_t History(wd_restart_record_t *records);
+static void SaveValue(unsigned long value);
+static unsigned long LoadValue(void);
+static void SleepMs(unsigned long ms);
+static unsigned long NowMs(clockid_t clock);
+static unsigned long ToMs(const struct timespec *time);
+static void WaitFor(unsigned int secs);
+
+static char *g_path = NULL;
+static const char *g_scenario = NULL;
+static int g_results = -1;
 
 int main(int argc, char *argv[])
+{
+    TH_TEST_T tests[] = {
+        {"start", TestStart},
+        {"shared_memory", TestSharedMemory},
+        {"exit_detection", TestExitDetection},
+        {"restart_history", TestRestartHistory},
+        {"posix_spawn", TestPosixSpawn},
+        {"vfork", TestVfork},
+        {"stop_ack", TestStopAck},
+        {"handles", TestHandles},
+        {"supervisor", TestSupervisor},
+        {"restart_limit", TestRestartLimit},
+        {"app_kick", TestAppKick},
+        {"threads", TestThreads},
+        {"phi", TestPhi},
+        {"progress", TestProgress},
+        {"inherited_memory", TestInheritedMemory},
+        {"start_async", TestStartAsync},
+        {"listener", TestListener},
+        {"standby", TestStandby},
+        {"zygote", TestZygote},
+        {"checkpoint", TestCheckpoint},
+        {"recorder", TestRecorder},
+        TH_TESTS_ARRAY_END
+    };
+    TH_TEST_T selected[] = {TH_TESTS_ARRAY_END, TH_TESTS_ARRAY_END};
+    size_t i = 0;
+
+    if (3 == argc)
+    {
+        return (RunScenario(argc, argv));
+    }
+
+    g_path = argv[0];
+
+    if (2 != argc)
+    {
+        TH_RUN_TESTS(tests);
+
+        return (0);
+    }
+
+    for (i = 0; NULL != tests[i].TH_TEST_FUNC; ++i)
+    {
+        if (0 == strcmp(argv[1], tests[i].TH_INFO_MESSAGE))
+        {
+            selected[0] = tests[i];
+        }
+    }
+
+    TH_RUN_TESTS(selected);
+
+	return (0);
+}
+
+/******************************************************************************/
+
+static void TestStart(void)
+{
+    TH_ASSERT(Launch("start"));
+}
+
+static void TestSharedMemory(void)
+{
+    TH_ASSERT(Launch("shared_memory"));
+}
+
+static void TestExitDetection(void)
+{
+    TH_ASSERT(Launch("exit_detection"));
+}
+
+static void TestRestartHistory(void)
+{
+    TH_ASSERT(Launch("restart_history"));
+}
+
+static void TestPosixSpawn(void)
+{
+    TH_ASSERT(Launch("posix_spawn"));
+}
+
+static void TestVfork(void)
+{
+    TH_ASSERT(Launch("vfork"));
+}
+
+static void TestStopAck(void)
+{
+    TH_ASSERT(Launch("stop_ack"));
+}
+
+static void TestHandles(void)
+{
+    TH_ASSERT(Launch("handles"));
+}
+
+static void TestSupervisor(void)
+{
+    TH_ASSERT(Launch("supervisor"));
+}
+
+static void TestRestartLimit(void)
+{
+    TH_ASSERT(Launch("restart_limit"));
+}
+
+static void TestAppKick(void)
+{
+    TH_ASSERT(Launch("app_kick"));
+}
+
+static void TestThreads(void)
+{
+    TH_ASSERT(Launch("threads"));
+}
+
+static void TestPhi(void)
+{
+    TH_ASSERT(Launch("phi"));
+}
+
+static void TestProgress(void)
+{
+    TH_ASSERT(Launch("progress"));
+}
+
+static void TestInheritedMemory(void)
+{
+    TH_ASSERT(Launch("inherited_memory"));
+}
+
+static void TestStartAsync(void)
+{
+    TH_ASSERT(Launch("start_async"));
+}
+
+static void TestListener(void)
+{
+    TH_ASSERT(Launch("listener"));
+}
+
+static void TestStandby(void)
+{
+    TH_ASSERT(Launch("standby"));
+}
+
+static void TestZygote(void)
+{
+    TH_ASSERT(Launch("zygote"));
+}
+
+static void TestCheckpoint(void)
+{
+    TH_ASSERT(Launch("checkpoint"));
+}
+
+static void TestRecorder(void)
+{
+    TH_ASSERT(Launch("recorder"));
+}
+
+/* the instances of the scenario, the watchdog and whatever else they start
+   inherit the write end of the pipe, so it is closed once they all have
+   exited. The scenario passes if one of them reported it done and none
+   reported a failure */
+static int Launch(const char *name)
+{
+    char report[REPORT_SIZE] = {0};
+    char fd_str[LINE_SIZE] = {0};
+    char *args[4] = {NULL};
+    char *line = NULL;
+    struct pollfd pfd = {0};
+    unsigned long deadline_ms = NowMs(CLOCK_MONOTONIC) + LAUNCH_TIMEOUT_MS;
+    unsigned long now_ms = 0;
+    size_t size = 0;
+    ssize_t amount = 0;
+    int is_closed = FALSE;
+    int is_done = FALSE;
+    int is_failed = FALSE;
+    int fds[2] = {0};
+    pid_t pid = 0;
+
+    remove(VALUE_FILE);
+
+    if (0 != pipe(fds))
+    {
+        return (FALSE);
+    }
+
+    sprintf(fd_str, "%d", fds[1]);
+
+    args[0] = g_path;
+    args[1] = (char *)name;
+    args[2] = fd_str;
+
+    fflush(stdout);
+
+    pid = fork();
+    if (0 == pid)
+    {
+        setpgid(0, 0);
+        close(fds[0]);
+        execv(g_path, args);
+        _exit(1);
+    }
+
+    setpgid(pid, pid);
+    close(fds[1]);
+
+    pfd.fd = fds[0];
+    pfd.events = POLLIN;
+
+    while (!is_closed && (now_ms = NowMs(CLOCK_MONOTONIC)) < deadline_ms
+        && 0 < poll(&pfd, 1, (int)(deadline_ms - now_ms)))
+    {
+        amount = read(fds[0], report + size, REPORT_SIZE - 1 - size);
+        if (0 >= amount)
+        {
+            is_closed = (0 == amount || REPORT_SIZE - 1 == size);
+            continue;
+        }
+
+        size += (size_t)amount;
+    }
+
+    if (!is_closed)
+    {
+        printf("%s timed out\n", name);
+    }
+
+    /* whatever is left of a failed scenario */
+    kill(-pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+    close(fds[0]);
+
+    is_done = (NULL != strstr(report, DONE));
+    is_failed = (NULL != strstr(report, FAIL));
+
+    for (line = strtok(report, "\n"); NULL != line; line = strtok(NULL, "\n"))
+    {
+        if (0 == strncmp(line, FAIL, strlen(FAIL)))
+        {
+            printf("%s\n", line);
+        }
+    }
+
+    return (is_closed && is_done && !is_failed);
+}
+
+/* runs in every instance of the scenario, with the arguments it was started
+   with: the name of the scenario and the pipe to report to */
+static int RunScenario(int argc, char *argv[])
+{
+    scenario_t scenarios[] = {
+        {"start", RunStart},
+        {"shared_memory", RunSharedMemory},
+        {"exit_detection", RunExitDetection},
+        {"restart_history", RunRestartHistory},
+        {"posix_spawn", RunPosixSpawn},
+        {"vfork", RunVfork},
+        {"stop_ack", RunStopAck},
+        {"handles", RunHandles},
+        {"supervisor", RunSupervisor},
+        {"restart_limit", RunRestartLimit},
+        {"app_kick", RunAppKick},
+        {"threads", RunThreads},
+        {"phi", RunPhi},
+        {"progress", RunProgress},
+        {"inherited_memory", RunInheritedMemory},
+        {"start_async", RunStartAsync},
+        {"listener", RunListener},
+        {"standby", RunStandby},
+        {"zygote", RunZygote},
+        {"checkpoint", RunCheckpoint},
+        {"recorder", RunRecorder}
+    };
+    size_t i = 0;
+
+    g_scenario = argv[1];
+    g_results = (int)strtol(argv[2], NULL, 10);
+
+    for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); ++i)
+    {
+        if (0 == strcmp(g_scenario, scenarios[i].name))
+        {
+            return (scenarios[i].Run(argc, argv));
+        }
+    }
+
+    CHECK(FALSE);
+
+    return (1);
+}
+
+/******************************************************************************/
+
+static int RunStart(int argc, char *argv[])
 {
     time_t end_of_test_time = time(NULL) + TIMEOUT;
     int i = 0;
 
-    if (0 != WDStart(argc, argv, DOWNTIME))
+    if (!CHECK(0 == WDStart(argc, argv, DOWNTIME)))
     {
         printf("Couldn't start the watchdog\n");
         return 0;
@@ -43,6 +461,1015 @@ int main(int argc, char *argv[])
     };
 
     WDStop();
+    Done();
 
 	return (0);
-}
\ No newline at end of file
+}
+
+/* a stopped program stops beating, a running one is left alone */
+static int RunSharedMemory(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+
+    options.downtime_ms = DOWNTIME_MS;
+    options.heartbeat = WD_HEARTBEAT_SHARED_MEMORY;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    if (0 == History(records))
+    {
+        SleepMs(DOWNTIME_MS / 2);
+        Hang();
+    }
+
+    SleepMs(2 * DOWNTIME_MS);
+
+    CHECK(1 == History(records));
+    CHECK(records[0].is_hang && !records[0].is_watchdog);
+    CHECK(getpid() == records[0].new_pid);
+
+    WDStop();
+    Done();
+
+    return (0);
+}
+
+/* the exits are noticed long before the downtime, of the program that
+   started the watchdog as well as of a program the watchdog started */
+static int RunExitDetection(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    size_t amount = 0;
+
+    options.downtime_ms = LONG_DOWNTIME_MS;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    amount = History(records);
+
+    if (0 != amount)
+    {
+        CHECK(!records[amount - 1].is_hang);
+        CHECK((long)(ToMs(&records[amount - 1].exit_time) - LoadValue())
+              < DETECTION_MS);
+    }
+
+    if (2 > amount)
+    {
+        SaveValue(NowMs(CLOCK_REALTIME));
+        Crash();
+    }
+
+    WDStop();
+    remove(VALUE_FILE);
+    Done();
+
+    return (0);
+}
+
+/* every crash is restarted once and recorded with the way it exited, the
+   status of the first program belongs to its own parent */
+static int RunRestartHistory(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    size_t amount = 0;
+    size_t i = 0;
+
+    options.downtime_ms = DOWNTIME_MS;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    amount = History(records);
+
+    if (1 == amount)
+    {
+        raise(SIGKILL);
+    }
+
+    if (3 > amount)
+    {
+        Crash();
+    }
+
+    CHECK(3 == amount);
+    CHECK(getpid() == records[amount - 1].new_pid);
+
+    for (i = 0; i < amount; ++i)
+    {
+        CHECK(!records[i].is_hang && !records[i].is_watchdog);
+        CHECK(ToMs(&records[i].exit_time) <= ToMs(&records[i].restart_time));
+        CHECK(i + 1 == amount || records[i].new_pid == records[i + 1].pid);
+    }
+
+    CHECK(!records[0].is_status_known);
+    CHECK(records[1].is_status_known && SIGKILL == records[1].term_signal);
+    CHECK(-1 == records[1].exit_code);
+    CHECK(records[2].is_status_known && CRASH_CODE == records[2].exit_code);
+    CHECK(0 == records[2].term_signal);
+
+    WDStop();
+    Done();
+
+    return (0);
+}
+
+static int RunPosixSpawn(int argc, char *argv[])
+{
+    return (RunSpawn(argc, argv, WD_SPAWN_POSIX_SPAWN));
+}
+
+static int RunVfork(int argc, char *argv[])
+{
+    return (RunSpawn(argc, argv, WD_SPAWN_VFORK));
+}
+
+/* the watchdog restarts the program and the program restarts the watchdog,
+   its parent then, the same way */
+static int RunSpawn(int argc, char *argv[], wd_spawn_t spawn)
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    unsigned long deadline_ms = 0;
+
+    options.downtime_ms = DOWNTIME_MS;
+    options.spawn = spawn;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    if (0 == History(records))
+    {
+        Crash();
+    }
+
+    CHECK(getpid() == records[0].new_pid);
+
+    kill(getppid(), SIGKILL);
+
+    deadline_ms = NowMs(CLOCK_MONOTONIC) + 2 * DOWNTIME_MS;
+    while (2 > History(records) && NowMs(CLOCK_MONOTONIC) < deadline_ms)
+    {
+        SleepMs(KICKTIME_MS);
+    }
+
+    CHECK(2 == History(records));
+    CHECK(records[1].is_watchdog && 0 == kill(records[1].new_pid, 0));
+
+    WDStop();
+    Done();
+
+    return (0);
+}
+
+/* the stop is acknowledged at once rather than after the kicks stop */
+static int RunStopAck(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    unsigned long start_ms = 0;
+
+    options.downtime_ms = DOWNTIME_MS;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    SleepMs(DOWNTIME_MS / 2);
+
+    start_ms = NowMs(CLOCK_MONOTONIC);
+    CHECK(0 == WDStopEx(DOWNTIME_MS));
+    CHECK(NowMs(CLOCK_MONOTONIC) - start_ms < STOP_MS);
+
+    Done();
+
+    return (0);
+}
+
+/* only the first handle restarts the program, the watchdog of the other
+   one exits and is started again by the restarted program */
+static int RunHandles(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_options_t other_options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    wd_t *restarter = NULL;
+    wd_t *other = NULL;
+    size_t amount = 0;
+
+    options.downtime_ms = DOWNTIME_MS;
+    other_options.downtime_ms = DOWNTIME_MS;
+    other_options.heartbeat = WD_HEARTBEAT_SHARED_MEMORY;
+
+    restarter = WDCreate(&options);
+    other = WDCreate(&other_options);
+
+    if (!CHECK(NULL != restarter && NULL != other)
+     || !CHECK(0 == WDStartHandle(restarter, argc, argv))
+     || !CHECK(0 == WDStartHandle(other, argc, argv)))
+    {
+        return (1);
+    }
+
+    amount = WDGetRestartHistoryHandle(restarter, records, WD_HISTORY_SIZE);
+
+    if (0 == amount)
+    {
+        SleepMs(DOWNTIME_MS / 2);
+        Crash();
+    }
+
+    CHECK(1 == amount && getpid() == records[0].new_pid);
+
+    SleepMs(DOWNTIME_MS);
+
+    CHECK(0 == WDStopHandle(other, DOWNTIME_MS));
+    CHECK(0 == WDStopHandle(restarter, DOWNTIME_MS));
+
+    WDDestroy(other);
+    WDDestroy(restarter);
+
+    Done();
+
+    return (0);
+}
+
+/* the first instance starts the supervisor and hangs, the instance the
+   supervisor starts instead stops it. Both register two handles, which
+   must not make the supervisor restart two copies. The hang comes right
+   after the first check of the kicks and is still caught within the
+   downtime */
+static int RunSupervisor(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    pid_t supervisor = getppid();
+    int is_first = (0 == LoadValue());
+    unsigned long deadline_ms = 0;
+    int status = 0;
+    int fd = 0;
+    wd_t *wd = NULL;
+    wd_t *other = NULL;
+
+    options.downtime_ms = DOWNTIME_MS;
+    options.kicktime_ms = KICKTIME_MS;
+    options.supervisor = SOCKET_PATH;
+
+    if (is_first)
+    {
+        remove(SOCKET_PATH);
+        remove(RESTARTED_FILE);
+
+        supervisor = fork();
+        if (0 == supervisor)
+        {
+            execl(PATH_TO_WATCHDOG, PATH_TO_WATCHDOG, SUPERVISOR_ARG,
+                                                    SOCKET_PATH, (char *)NULL);
+            _exit(1);
+        }
+    }
+    else
+    {
+        CHECK(NowMs(CLOCK_MONOTONIC) - LoadValue()
+              < DOWNTIME_MS + DETECTION_MS);
+
+        fd = open(RESTARTED_FILE, O_CREAT | O_EXCL | O_WRONLY, 0600);
+        CHECK(0 <= fd);
+        close(fd);
+    }
+
+    wd = WDCreate(&options);
+    other = WDCreate(&options);
+    if (!CHECK(NULL != wd && NULL != other))
+    {
+        kill(supervisor, SIGTERM);
+        return (1);
+    }
+
+    /* the registration is refused until the supervisor listens */
+    deadline_ms = NowMs(CLOCK_MONOTONIC) + DOWNTIME_MS;
+    while (0 != (status = WDStartHandle(wd, argc, argv))
+        && NowMs(CLOCK_MONOTONIC) < deadline_ms)
+    {
+        SleepMs(KICKTIME_MS / 10);
+    }
+
+    if (!CHECK(0 == status && 0 == WDStartHandle(other, argc, argv)))
+    {
+        kill(supervisor, SIGTERM);
+        return (1);
+    }
+
+    if (is_first)
+    {
+        SleepMs(DOWNTIME_MS + 2 * KICKTIME_MS);
+        SaveValue(NowMs(CLOCK_MONOTONIC));
+        Hang();
+    }
+
+    /* a second copy would have been started along with this one */
+    SleepMs(2 * DOWNTIME_MS);
+
+    CHECK(0 == WDStopHandle(other, DOWNTIME_MS));
+    CHECK(0 == WDStopHandle(wd, DOWNTIME_MS));
+    WDDestroy(other);
+    WDDestroy(wd);
+
+    kill(supervisor, SIGTERM);
+    remove(VALUE_FILE);
+    remove(RESTARTED_FILE);
+    Done();
+
+    return (0);
+}
+
+/* the third crash within the window is one too many: the watchdog gives up
+   and exits. Only a process that outlives the program can tell, so the
+   last instance leaves a child behind to check the history */
+static int RunRestartLimit(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    size_t amount = 0;
+
+    options.downtime_ms = DOWNTIME_MS;
+    options.max_restarts = WD_HISTORY_SIZE + 1;
+    CHECK(NULL == WDCreate(&options));
+
+    options.max_restarts = 2;
+    options.backoff_min_ms = BACKOFF_MS;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    amount = History(records);
+
+    if (2 == amount && 0 == fork())
+    {
+        SleepMs(DOWNTIME_MS);
+
+        CHECK(3 == History(records));
+        CHECK(records[2].is_given_up && 0 == records[2].new_pid);
+        CHECK(BACKOFF_MS / 2 <= ToMs(&records[1].restart_time)
+                                - ToMs(&records[1].exit_time));
+
+        Done();
+        _exit(0);
+    }
+
+    Crash();
+
+    return (1);
+}
+
+/* a program that kicks by itself is hung once its own loop stops */
+static int RunAppKick(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    size_t i = 0;
+
+    options.downtime_ms = DOWNTIME_MS;
+    options.kicktime_ms = KICKTIME_MS;
+    options.is_app_kicked = TRUE;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    if (0 == History(records))
+    {
+        for (i = 0; i < KICKS; ++i)
+        {
+            WDKick();
+            SleepMs(KICKTIME_MS);
+        }
+
+        SleepMs(STALL_MS);
+    }
+
+    CHECK(1 == History(records));
+    CHECK(records[0].is_hang);
+
+    WDStop();
+    Done();
+
+    return (0);
+}
+
+/* a thread that stops kicking hangs the program, a late thread that is
+   only reported doesn't */
+static int RunThreads(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    wd_thread_t *thread = NULL;
+    pthread_t stalled;
+
+    options.downtime_ms = DOWNTIME_MS;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    if (0 == History(records))
+    {
+        thread = WDRegisterThread(NULL, THREAD_DEADLINE_MS, TRUE);
+        CHECK(NULL != thread);
+
+        SleepMs(2 * THREAD_DEADLINE_MS);
+
+        CHECK(WDIsThreadLate(thread));
+        WDUnregisterThread(thread);
+
+        CHECK(0 == pthread_create(&stalled, NULL, StallThread, NULL));
+
+        SleepMs(STALL_MS);
+    }
+
+    CHECK(1 == History(records));
+    CHECK(records[0].is_hang);
+
+    WDStop();
+    Done();
+
+    return (0);
+}
+
+static void *StallThread(void *param)
+{
+    wd_thread_t *thread = WDRegisterThread(NULL, THREAD_DEADLINE_MS, FALSE);
+    size_t i = 0;
+
+    (void)param;
+
+    CHECK(NULL != thread);
+
+    for (i = 0; i < KICKS; ++i)
+    {
+        WDThreadKick(thread);
+        SleepMs(KICKTIME_MS);
+    }
+
+    SleepMs(STALL_MS);
+
+    return (NULL);
+}
+
+/* the kicks are regular, so a stall is suspected long before the downtime */
+static int RunPhi(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    wd_detector_stats_t stats = {0};
+    size_t i = 0;
+
+    options.downtime_ms = LONG_DOWNTIME_MS;
+    options.kicktime_ms = KICKTIME_MS;
+    options.is_app_kicked = TRUE;
+    options.phi_threshold = PHI_THRESHOLD;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    if (0 == History(records))
+    {
+        for (i = 0; i < PHI_KICKS; ++i)
+        {
+            WDKick();
+            SleepMs(KICKTIME_MS);
+        }
+
+        CHECK(0 == WDGetDetectorStats(NULL, TRUE, &stats));
+        CHECK(0 < stats.samples);
+        CHECK(KICKTIME_MS / 2 < stats.mean_ms
+              && stats.mean_ms < 2 * KICKTIME_MS);
+
+        SaveValue(NowMs(CLOCK_REALTIME));
+        SleepMs(2 * LONG_DOWNTIME_MS);
+    }
+
+    CHECK(1 == History(records));
+    CHECK(records[0].is_hang);
+    CHECK((long)(ToMs(&records[0].exit_time) - LoadValue())
+          < LONG_DOWNTIME_MS / 2);
+
+    WDStop();
+    remove(VALUE_FILE);
+    Done();
+
+    return (0);
+}
+
+/* the kicks go on, the work doesn't */
+static int RunProgress(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    size_t i = 0;
+
+    options.downtime_ms = DOWNTIME_MS;
+    options.kicktime_ms = KICKTIME_MS;
+    options.progress_window_ms = PROGRESS_WINDOW_MS;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    if (0 == History(records))
+    {
+        for (i = 0; i < KICKS; ++i)
+        {
+            WDProgress(1);
+            SleepMs(KICKTIME_MS);
+        }
+
+        SleepMs(STALL_MS);
+    }
+
+    CHECK(1 == History(records));
+    CHECK(records[0].is_stalled && records[0].is_hang);
+
+    WDStop();
+    Done();
+
+    return (0);
+}
+
+/* the memory shared with the watchdog is passed down as a descriptor, no
+   name is left behind in /dev/shm */
+static int RunInheritedMemory(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    size_t names = CountSharedMemory();
+
+    options.downtime_ms = DOWNTIME_MS;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    CHECK(names == CountSharedMemory());
+
+    if (0 == History(records))
+    {
+        Crash();
+    }
+
+    CHECK(1 == History(records));
+    CHECK(getpid() == records[0].new_pid);
+
+    WDStop();
+
+    CHECK(names == CountSharedMemory());
+
+    Done();
+
+    return (0);
+}
+
+static size_t CountSharedMemory(void)
+{
+    DIR *dir = opendir("/dev/shm");
+    size_t amount = 0;
+
+    if (NULL == dir)
+    {
+        return (0);
+    }
+
+    while (NULL != readdir(dir))
+    {
+        ++amount;
+    }
+
+    closedir(dir);
+
+    return (amount);
+}
+
+/* the program goes on while the watchdog comes up */
+static int RunStartAsync(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    volatile int status = NOT_STARTED;
+    unsigned long deadline_ms = 0;
+
+    options.downtime_ms = DOWNTIME_MS;
+
+    if (!CHECK(0 == WDStartAsync(argc, argv, &options, OnReady,
+                                 (void *)&status)))
+    {
+        return (1);
+    }
+
+    deadline_ms = NowMs(CLOCK_MONOTONIC) + DOWNTIME_MS;
+    while (NOT_STARTED == status && NowMs(CLOCK_MONOTONIC) < deadline_ms)
+    {
+        SleepMs(KICKTIME_MS / 10);
+    }
+
+    CHECK(READY == status);
+
+    if (0 == History(records))
+    {
+        Crash();
+    }
+
+    CHECK(1 == History(records));
+
+    WDStop();
+    Done();
+
+    return (0);
+}
+
+static void OnReady(int status, void *param)
+{
+    *(volatile int *)param = (0 == status) ? READY : NOT_READY;
+}
+
+/* a client that connects while the program is restarted is served by the
+   restarted program, on the socket the watchdog kept */
+static int RunListener(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    struct sockaddr_in addr = {0};
+    socklen_t addr_size = sizeof(addr);
+    char buffer[LINE_SIZE] = {0};
+    int fd = -1;
+    int connection = -1;
+
+    options.downtime_ms = DOWNTIME_MS;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    fd = WDGetListener(NULL, LISTENER_KEY);
+
+    if (0 == History(records))
+    {
+        CHECK(-1 == fd);
+
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        CHECK(0 == bind(fd, (struct sockaddr *)&addr, sizeof(addr)));
+        CHECK(0 == listen(fd, SOMAXCONN));
+        CHECK(0 == getsockname(fd, (struct sockaddr *)&addr, &addr_size));
+        CHECK(0 == WDRegisterListener(NULL, LISTENER_KEY, fd));
+
+        /* the watchdog receives the socket with the next kick */
+        SleepMs(DOWNTIME_MS / 2);
+
+        if (0 == fork())
+        {
+            close(fd);
+            SleepMs(DOWNTIME_MS / 4);
+
+            fd = socket(AF_INET, SOCK_STREAM, 0);
+            CHECK(0 == connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+            CHECK((ssize_t)sizeof(MESSAGE) == write(fd, MESSAGE,
+                                                    sizeof(MESSAGE)));
+            close(fd);
+            _exit(0);
+        }
+
+        Crash();
+    }
+
+    if (!CHECK(-1 != fd))
+    {
+        return (1);
+    }
+
+    while (-1 == (connection = accept(fd, NULL, NULL)) && EINTR == errno)
+    {
+    }
+
+    CHECK(-1 != connection);
+    CHECK((ssize_t)sizeof(MESSAGE) == read(connection, buffer, LINE_SIZE));
+    CHECK(0 == strcmp(buffer, MESSAGE));
+
+    close(connection);
+
+    WDStop();
+    Done();
+
+    return (0);
+}
+
+/* the parked standby takes over when the program dies */
+static int RunStandby(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+
+    options.downtime_ms = DOWNTIME_MS;
+    options.is_hot_standby = TRUE;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    /* warming up */
+    SleepMs(DOWNTIME_MS / 4);
+
+    if (!CHECK(0 == WDAwaitPromotion(NULL)))
+    {
+        return (1);
+    }
+
+    if (0 == History(records))
+    {
+        SleepMs(DOWNTIME_MS);
+        Crash();
+    }
+
+    CHECK(1 == History(records));
+    CHECK(records[0].is_standby && getpid() == records[0].new_pid);
+
+    WDStop();
+    Done();
+
+    return (0);
+}
+
+/* the program is forked by the zygote, and restarted by exec once the
+   zygote is gone */
+static int RunZygote(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    size_t amount = 0;
+
+    options.downtime_ms = DOWNTIME_MS;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options))
+     || !CHECK(0 == WDForkPoint(NULL)))
+    {
+        return (1);
+    }
+
+    amount = History(records);
+
+    if (1 == amount)
+    {
+        CHECK(records[0].is_zygote && getpid() == records[0].new_pid);
+
+        /* the zygote forked the program */
+        kill(getppid(), SIGKILL);
+        SleepMs(KICKTIME_MS);
+    }
+
+    if (2 > amount)
+    {
+        Crash();
+    }
+
+    CHECK(2 == amount);
+    CHECK(!records[1].is_zygote && getpid() == records[1].new_pid);
+    CHECK(ToMs(&records[1].restart_time) - ToMs(&records[1].exit_time)
+          < DOWNTIME_MS / 2);
+
+    WDStop();
+    Done();
+
+    return (0);
+}
+
+/* what the program writes to the region is there after a restart */
+static int RunCheckpoint(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    char *region = NULL;
+
+    options.downtime_ms = DOWNTIME_MS;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    region = (char *)WDCheckpointRegion(CHECKPOINT_SIZE);
+
+    if (!CHECK(NULL != region))
+    {
+        return (1);
+    }
+
+    if (0 == History(records))
+    {
+        CHECK('\0' == region[0]);
+        strcpy(region, CHECKPOINT);
+
+        /* the watchdog receives the region with the next kick */
+        SleepMs(DOWNTIME_MS / 2);
+        Crash();
+    }
+
+    CHECK(0 == strcmp(region, CHECKPOINT));
+
+    WDStop();
+    Done();
+
+    return (0);
+}
+
+/* the events recorded before a crash are dumped by the watchdog */
+static int RunRecorder(int argc, char *argv[])
+{
+    wd_options_t options = {0};
+    wd_restart_record_t records[WD_HISTORY_SIZE];
+    wd_recorder_t *recorder = NULL;
+    char name[LINE_SIZE] = {0};
+    char line[LINE_SIZE] = {0};
+    unsigned long event[4] = {0};
+    int is_found = FALSE;
+    FILE *events = NULL;
+
+    options.downtime_ms = DOWNTIME_MS;
+
+    if (!CHECK(0 == WDStartEx(argc, argv, &options)))
+    {
+        return (1);
+    }
+
+    if (0 == History(records))
+    {
+        recorder = WDRegisterRecorder(NULL);
+        CHECK(NULL != recorder);
+
+        WDRecordEvent(recorder, EVENT_CODE, EVENT_ARG);
+        Crash();
+    }
+
+    sprintf(name, "watchdog_%d.events", (int)records[0].pid);
+
+    events = fopen(name, "r");
+    if (!CHECK(NULL != events))
+    {
+        return (1);
+    }
+
+    while (NULL != fgets(line, LINE_SIZE, events))
+    {
+        if ('#' != line[0]
+         && 4 == sscanf(line, "%lu %lu %lu %lu", event, event + 1,
+                                                 event + 2, event + 3)
+         && EVENT_CODE == event[2] && EVENT_ARG == event[3])
+        {
+            is_found = TRUE;
+        }
+    }
+
+    fclose(events);
+    remove(name);
+
+    CHECK(is_found);
+
+    WDStop();
+    Done();
+
+    return (0);
+}
+
+/******************************************************************************/
+
+static int Check(int is_true, int line)
+{
+    char message[LINE_SIZE] = {0};
+
+    if (!is_true)
+    {
+        sprintf(message, "%s: %s, line %d, pid %d\n", FAIL, g_scenario, line,
+                                                                (int)getpid());
+        Report(message);
+    }
+
+    return (is_true);
+}
+
+static void Report(const char *message)
+{
+    ssize_t amount = 0;
+
+    do
+    {
+        amount = write(g_results, message, strlen(message));
+    }
+    while (-1 == amount && EINTR == errno);
+}
+
+static void Done(void)
+{
+    Report(DONE);
+}
+
+static void Crash(void)
+{
+    _exit(CRASH_CODE);
+}
+
+/* a stopped process can only be killed */
+static void Hang(void)
+{
+    raise(SIGSTOP);
+}
+
+static size_t History(wd_restart_record_t *records)
+{
+    return (WDGetRestartHistory(records, WD_HISTORY_SIZE));
+}
+
+/* the instances of a scenario pass values to each other through a file */
+static void SaveValue(unsigned long value)
+{
+    FILE *file = fopen(VALUE_FILE, "w");
+
+    if (NULL != file)
+    {
+        fprintf(file, "%lu\n", value);
+        fclose(file);
+    }
+}
+
+static unsigned long LoadValue(void)
+{
+    FILE *file = fopen(VALUE_FILE, "r");
+    unsigned long value = 0;
+
+    if (NULL != file)
+    {
+        if (1 != fscanf(file, "%lu", &value))
+        {
+            value = 0;
+        }
+
+        fclose(file);
+    }
+
+    return (value);
+}
+
+/* the kicks of the signal heartbeat interrupt the sleep */
+static void SleepMs(unsigned long ms)
+{
+    struct timespec left = {0};
+
+    left.tv_sec = (time_t)(ms / MSEC_IN_SEC);
+    left.tv_nsec = (long)(ms % MSEC_IN_SEC) * NSEC_IN_MSEC;
+
+    while (-1 == nanosleep(&left, &left) && EINTR == errno)
+    {
+    }
+}
+
+static unsigned long NowMs(clockid_t clock)
+{
+    struct timespec now = {0};
+
+    clock_gettime(clock, &now);
+
+    return (ToMs(&now));
+}
+
+static unsigned long ToMs(const struct timespec *time)
+{
+    return ((unsigned long)time->tv_sec * MSEC_IN_SEC
+            + (unsigned long)time->tv_nsec / NSEC_IN_MSEC);
+}
+
+static void WaitFor(unsigned int secs)
+{
+    unsigned int retTime = time(0) + secs;
+    while (time(0) < retTime);
+}